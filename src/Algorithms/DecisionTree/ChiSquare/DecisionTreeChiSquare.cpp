@@ -15,9 +15,58 @@
 */
 
 #include "DecisionTreeChiSquare.hpp"
+#include <algorithm>
+#include <cmath>
 
 using namespace DataMiner;
 
+/**
+ * Helper function to compute the regularized upper incomplete gamma function Q(a, x), which is the p-value of a
+ * chi-square statistic of 2x with 2a degrees of freedom
+ * 
+ * @param a The shape (greater than 0)
+ * @param x The point (at least 0)
+ * @returns Q(a, x)
+ */
+static double upperGamma(double a, double x) {
+	if (x <= 0)
+		return 1;
+	double scale = std::exp(a * std::log(x) - x - std::lgamma(a));
+
+	// The series converges quickly below a + 1, the continued fraction above it
+	if (x < a + 1) {
+		double term = 1 / a;
+		double sum = term;
+		for (double n = 1; n < 1000 && term > sum * 1e-15; n++) {
+			term *= x / (a + n);
+			sum += term;
+		}
+		return std::max(0.0, 1 - sum * scale);
+	}
+
+	const double tiny = 1e-300;
+	double b = x + 1 - a;
+	double c = 1 / tiny;
+	double d = 1 / b;
+	double fraction = d;
+	for (double n = 1; n < 1000; n++) {
+		double an = -n * (n - a);
+		b += 2;
+		d = an * d + b;
+		if (std::fabs(d) < tiny)
+			d = tiny;
+		c = b + an / c;
+		if (std::fabs(c) < tiny)
+			c = tiny;
+		d = 1 / d;
+		double delta = d * c;
+		fraction *= delta;
+		if (std::fabs(delta - 1) < 1e-15)
+			break;
+	}
+	return fraction * scale;
+}
+
 /**
  * Create a decision tree based using the Chi Squared splitting method
  * 
@@ -25,5 +74,118 @@ using namespace DataMiner;
  * @param dataset The dataset to use for the creation of the tree
  */
 void DataMiner::Algorithm::DecisionTreeChiSquare::createDecisionTree(const Data& dataset) {
+	setupTree(dataset);
+	growTree();
+}
+
+/**
+ * Returns the smallest chi-square statistic whose p-value is below the significance level, worked out from the
+ * chi-square distribution once per amount of degrees of freedom
+ * 
+ * @param degrees The degrees of freedom
+ * @returns The statistic
+ */
+double DataMiner::Algorithm::DecisionTreeChiSquare::criticalValue(size_t degrees) const {
+	std::lock_guard<std::mutex> guard(criticalLock);
+	auto found = criticalValues.find(degrees);
+	if (found != criticalValues.end())
+		return found->second;
+
+	// The p-value falls as the statistic grows, so the statistic at the significance level can be bisected for
+	double shape = degrees / 2.0;
+	double low = 0;
+	double high = degrees + 10.0;
+	while (upperGamma(shape, high / 2) > significance)
+		high *= 2;
+	for (int i = 0; i < 100 && high - low > high * 1e-12; i++) {
+		double middle = (low + high) / 2;
+		if (upperGamma(shape, middle / 2) > significance)
+			low = middle;
+		else
+			high = middle;
+	}
+
+	criticalValues[degrees] = high;
+	return high;
+}
+
+/**
+ * Chooses the split of a node whose contingency table has the largest chi-square statistic, if it is significant
+ * 
+ * With n rows, c rows per class and l/r rows per class on the left/right side, the statistic of the (side x class)
+ * table is n * (sum(l^2 / c) / left + sum(r^2 / c) / right - 1), where both sums are kept up to date per class as
+ * values move to the left side. Every split of a node has the same degrees of freedom (the classes present in the
+ * node, less one), so the largest statistic also has the smallest p-value
+ * 
+ * @throws A string description of why the process failed
+ * @param table The amount of the node's rows with each value and class, `numClasses` counts per value
+ * @param feature The feature
+ * @param counts The amount of the node's rows in each class
+ * @returns The best split, scored by its chi-square statistic
+ */
+Algorithm::DecisionTree::DecisionTreeSplit DataMiner::Algorithm::DecisionTreeChiSquare::chooseSplit(const std::vector<uint32_t>& table, const DecisionTreeFeature& feature, const std::vector<uint32_t>& counts) const {
+	double total = 0;
+	size_t present = 0;
+	for (uint32_t count : counts) {
+		total += count;
+		if (count > 0)
+			present++;
+	}
+
+	DecisionTreeSplit best;
+	if (present < 2)
+		return best;
+	double critical = criticalValue(present - 1);
+
+	std::vector<double> left(numClasses, 0);
+	double leftRows = 0;
+	double leftSum = 0;
+	double rightSum = total;
+	for (size_t value = 0; value < feature.values; value++) {
+		const uint32_t* cells = table.data() + value * numClasses;
+		double rows = 0;
+		for (size_t i = 0; i < numClasses; i++)
+			rows += cells[i];
+		if (rows == 0)
+			continue;
+
+		if (feature.ordered()) {
+			// Moving m rows of a class from the right to the left side
+			for (size_t i = 0; i < numClasses; i++) {
+				double moved = cells[i];
+				if (moved == 0)
+					continue;
+				double right = counts[i] - left[i];
+				leftSum += moved * (2 * left[i] + moved) / counts[i];
+				rightSum += moved * (moved - 2 * right) / counts[i];
+				left[i] += moved;
+			}
+			leftRows += rows;
+		}
+		else {
+			// Only this value is on the left side
+			leftSum = 0;
+			rightSum = 0;
+			for (size_t i = 0; i < numClasses; i++) {
+				if (counts[i] == 0)
+					continue;
+				double right = static_cast<double>(counts[i]) - cells[i];
+				leftSum += static_cast<double>(cells[i]) * cells[i] / counts[i];
+				rightSum += right * right / counts[i];
+			}
+			leftRows = rows;
+		}
+
+		double rightRows = total - leftRows;
+		if (leftRows < minLeafRows || rightRows < minLeafRows)
+			continue;
+
+		double statistic = total * (leftSum / leftRows + rightSum / rightRows - 1);
+		if (statistic > critical && statistic > best.score) {
+			best.value = static_cast<uint32_t>(value);
+			best.score = statistic;
+		}
+	}
 
+	return best;
 }
\ No newline at end of file
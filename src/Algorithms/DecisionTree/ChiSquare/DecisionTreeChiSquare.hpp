@@ -17,6 +17,8 @@
 #pragma once
 
 #include <Algorithms/DecisionTree/DecisionTree.hpp>
+#include <map>
+#include <mutex>
 
 /**
  * Main data mining namespace
@@ -25,10 +27,53 @@ namespace DataMiner::Algorithm {
 		
 	/**
 	 * Algorithm for decision trees
+	 * 
+	 * Each candidate split is scored by the chi-square statistic of its (side x class) contingency table, which is worked
+	 * out from the feature's (value x class) table counted in one pass over the node's rows, and splits are only made
+	 * when the statistic is significant
 	 */
 	class DecisionTreeChiSquare : public DecisionTree {
+	private:
+
+		/**
+		 * The smallest statistic which is significant for every amount of degrees of freedom asked for so far
+		 */
+		mutable std::map<size_t, double> criticalValues;
+
+		/**
+		 * Guards `criticalValues`
+		 */
+		mutable std::mutex criticalLock;
+
+		/**
+		 * Returns the smallest chi-square statistic whose p-value is below the significance level, worked out from the
+		 * chi-square distribution once per amount of degrees of freedom
+		 * 
+		 * @param degrees The degrees of freedom
+		 * @returns The statistic
+		 */
+		double criticalValue(size_t degrees) const;
+
+	protected:
+
+		/**
+		 * Chooses the split of a node whose contingency table has the largest chi-square statistic, if it is significant
+		 * 
+		 * @throws A string description of why the process failed
+		 * @param table The amount of the node's rows with each value and class, `numClasses` counts per value
+		 * @param feature The feature
+		 * @param counts The amount of the node's rows in each class
+		 * @returns The best split, scored by its chi-square statistic
+		 */
+		DecisionTreeSplit chooseSplit(const std::vector<uint32_t>& table, const DecisionTreeFeature& feature, const std::vector<uint32_t>& counts) const;
+
 	public:
 
+		/**
+		 * The p-value below which a split is significant
+		 */
+		static constexpr double significance = 0.05;
+
 		/**
 		 * Create a decision tree based using the Chi Squared splitting method
 		 * 
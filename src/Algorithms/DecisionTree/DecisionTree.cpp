@@ -16,7 +16,14 @@
 
 #include "DecisionTree.hpp"
 #include <Logger/Logger.hpp>
+#include <Data/Number.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <iterator>
 #include <sstream>
+#include <unordered_map>
 
 using namespace DataMiner;
 
@@ -25,18 +32,102 @@ using namespace DataMiner;
  * 
  * @throws An error description string if the string couldn't be converted
  */
-static double getDouble(const std::string& str) {
-	try {
-		return std::stod(str);
-	}
-	catch (const std::invalid_argument&) {
+static double getDouble(std::string_view str) {
+	double value;
+	if (!parseNumber(str, value))
 		throw "Unable to convert string to a numeric value";
+	return value;
+}
+
+/**
+ * Helper function to write a number in the shortest form which reads back as the same number
+ * 
+ * @param stream The stream to write to
+ * @param value The number
+ */
+static void writeNumber(std::ostream& stream, double value) {
+	char buffer[32];
+	std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+	stream.write(buffer, result.ptr - buffer);
+}
+
+/**
+ * Helper function to write a column name or string value in quotes, escaping the quotes, backslashes and line breaks
+ * inside of it so names and values with spaces (or which look like keywords) keep to a single part of their line
+ * 
+ * @param stream The stream to write to
+ * @param value The string
+ */
+static void writeString(std::ostream& stream, const std::string& value) {
+	stream << '"';
+	for (char c : value) {
+		switch (c) {
+			case '"': stream << "\\\""; break;
+			case '\\': stream << "\\\\"; break;
+			case '\n': stream << "\\n"; break;
+			case '\r': stream << "\\r"; break;
+			default: stream << c;
+		}
 	}
-	catch (const std::out_of_range&) {
-		throw "Unable to convert string to a numeric value";
+	stream << '"';
+}
+
+/**
+ * Helper function to split a line of a save file into its space separated parts, undoing the escapes of quoted column
+ * names and string values (which are read whole, spaces included)
+ * 
+ * @throws A string if a quoted value is not closed at the end of its part
+ * @param line The line
+ * @param quoted Set to whether each part was quoted, quoted parts are never keywords
+ * @returns The parts of the line
+ */
+static std::vector<std::string> splitLine(const std::string& line, std::vector<bool>& quoted) {
+	std::vector<std::string> parts;
+	quoted.clear();
+	size_t i = 0;
+	while (i < line.size()) {
+		std::string part;
+		quoted.push_back(line[i] == '"');
+		if (quoted.back()) {
+			for (i++; i < line.size() && line[i] != '"'; i++) {
+				if (line[i] == '\\' && i + 1 < line.size()) {
+					i++;
+					part += line[i] == 'n' ? '\n' : line[i] == 'r' ? '\r' : line[i];
+				}
+				else {
+					part += line[i];
+				}
+			}
+			if (i >= line.size() || (i + 1 < line.size() && line[i + 1] != ' '))
+				throw "Invalid line detected in save file";
+			i += 2;
+		}
+		else {
+			size_t space = std::min(line.find(' ', i), line.size());
+			part = line.substr(i, space - i);
+			i = space + 1;
+		}
+		parts.push_back(std::move(part));
 	}
+	return parts;
 }
 
+/**
+ * The most classes a classification tree can predict, which bounds the size of the class count tables
+ */
+static const size_t maxClasses = 1024;
+
+/**
+ * Fewest rows a node needs before its features are searched in parallel, smaller nodes are searched faster than the
+ * threads can be handed the work
+ */
+static const size_t minParallelRows = 1 << 14;
+
+/**
+ * The text for every comparison in save files
+ */
+static const char* comparisonNames[] = { "==", "!=", "<=", ">" };
+
 // -------------------------- DecisionTreeCondition --------------------------
 
 /**
@@ -50,7 +141,12 @@ bool DataMiner::Algorithm::DecisionTree::DecisionTreeCondition::testCondition(co
 	if (conditionColumn.type == DataType::string)
 		throw "Invalid Data Type Error (Condition column is a string, number given)";
 	
-	return numValue == value;
+	switch (comparison) {
+		case Comparison::notEqual: return numValue != value;
+		case Comparison::lessEqual: return value <= numValue;
+		case Comparison::greater: return !(value <= numValue);
+		default: return numValue == value;
+	}
 }
 
 /**
@@ -60,11 +156,15 @@ bool DataMiner::Algorithm::DecisionTree::DecisionTreeCondition::testCondition(co
  * @param value The value to check for
  * @returns Whether or not the value passes the condition
  */
-bool DataMiner::Algorithm::DecisionTree::DecisionTreeCondition::testCondition(const std::string& value) const {
+bool DataMiner::Algorithm::DecisionTree::DecisionTreeCondition::testCondition(std::string_view value) const {
 	if (conditionColumn.type == DataType::number)
 		throw "Invalid Data Type Error (Condition column is a number, string given)";
 	
-	return strValue == value;
+	switch (comparison) {
+		case Comparison::equal: return strValue == value;
+		case Comparison::notEqual: return strValue != value;
+		default: throw "Invalid Condition Error (String values can only be compared for equality)";
+	}
 }
 
 // -------------------------- DecisionTreeRule --------------------------
@@ -118,6 +218,324 @@ void DataMiner::Algorithm::DecisionTree::createProcessor(const Data& dataset) {
 	}
 
 	createDecisionTree(dataset);
+
+	std::stringstream str;
+	str << "Decision Tree successfully created with " << rules.size() << " rule(s)";
+	logger->info(str.str().c_str());
+}
+
+/**
+ * Bins the numeric columns of the dataset, which the split searches count rows by
+ * 
+ * @throws A string with a description of why the task failed
+ * @param dataset The dataset to train on
+ */
+void DataMiner::Algorithm::DecisionTree::prepareDataset(Data& dataset) {
+	dataset.binNumericColumns();
+}
+
+/**
+ * Sets up `features`, and `rows` with every row which has a target value, along with the class (or target value for
+ * regression trees) of every row
+ * 
+ * @throws A string description of why the process failed
+ * @param dataset The dataset to use for the creation of the tree (its numeric columns must be binned for classification
+ * trees)
+ */
+void DataMiner::Algorithm::DecisionTree::setupTree(const Data& dataset) {
+	size_t nrows = dataset.numRows();
+	if (nrows > UINT32_MAX)
+		throw "Too many rows to train on";
+
+	features.clear();
+	for (size_t i = 0; i < dataset.numColumns(); i++) {
+		const DataColumn& col = dataset.getColumn(i);
+		if (col.role != DataRole::feature || !col.stored)
+			continue;
+
+		DecisionTreeFeature feature = { &col, nullptr, nullptr, nullptr, nullptr, 0 };
+		if (col.type == DataType::number) {
+			if (regression) {
+				features.push_back(feature);
+				continue;
+			}
+			feature.bins = dataset.getBins(i).data();
+			feature.edges = &dataset.getBinEdges(i);
+			feature.values = feature.edges->size();
+		}
+		// Arena encoded columns have close to a distinct value per row, which makes for useless splits
+		else if (col.encoding == StringEncoding::dictionary) {
+			feature.codes = dataset.getCodes(i);
+			feature.dictionary = &dataset.getDictionary(i);
+			feature.values = feature.dictionary->size();
+		}
+
+		if (feature.values > 0)
+			features.push_back(feature);
+	}
+
+	// Rows without a target value cannot be learned from, the others are given the class of their target value
+	size_t target = 0;
+	while (&dataset.getColumn(target) != targetColumn)
+		target++;
+	rows.clear();
+	classValues.clear();
+	classDictionary = nullptr;
+	numClasses = 0;
+	if (regression) {
+		if (targetColumn->type != DataType::number)
+			throw "Regression trees need a numeric target column";
+
+		rowValues.assign(nrows, 0);
+		for (uint32_t row = 0; row < nrows; row++) {
+			rowValues[row] = dataset.getNumber(target, row);
+			if (!std::isnan(rowValues[row]))
+				rows.push_back(row);
+		}
+	}
+	else if (targetColumn->type == DataType::string) {
+		if (targetColumn->encoding != StringEncoding::dictionary)
+			throw "The target column has too many distinct values to be used as classes";
+		classDictionary = &dataset.getDictionary(target);
+		numClasses = classDictionary->size();
+		if (numClasses > maxClasses)
+			throw "The target column has too many distinct values to be used as classes";
+
+		const uint32_t* codes = dataset.getCodes(target);
+		uint32_t missing = classDictionary->find("");
+		rowClasses.assign(nrows, 0);
+		for (uint32_t row = 0; row < nrows; row++) {
+			rowClasses[row] = codes[row];
+			if (codes[row] != missing)
+				rows.push_back(row);
+		}
+	}
+	else {
+		std::unordered_map<double, uint32_t> classes;
+		rowClasses.assign(nrows, 0);
+		for (uint32_t row = 0; row < nrows; row++) {
+			double value = dataset.getNumber(target, row);
+			if (std::isnan(value))
+				continue;
+			auto found = classes.emplace(value, static_cast<uint32_t>(classValues.size()));
+			if (found.second) {
+				if (classValues.size() == maxClasses)
+					throw "The target column has too many distinct values to be used as classes";
+				classValues.push_back(value);
+			}
+			rowClasses[row] = found.first->second;
+			rows.push_back(row);
+		}
+		numClasses = classValues.size();
+	}
+
+	if (rows.empty())
+		throw "The dataset has no rows with a target value to train on";
+}
+
+/**
+ * Grows the tree from a root holding every row of `rows`, splitting nodes with `findSplit`, then saves each leaf as a
+ * rule (`setupTree` must have been called)
+ * 
+ * @throws A string description of why the process failed
+ */
+void DataMiner::Algorithm::DecisionTree::growTree() {
+	pool = std::make_unique<ThreadPool>(threads);
+
+	DecisionTreeNode root;
+	root.begin = 0;
+	root.end = rows.size();
+	root.depth = 0;
+	if (!regression) {
+		root.classes.resize(rows.size());
+		for (size_t i = 0; i < rows.size(); i++)
+			root.classes[i] = rowClasses[rows[i]];
+	}
+	growNode(root);
+
+	features.clear();
+	rows = std::vector<uint32_t>();
+	rowClasses = std::vector<uint32_t>();
+	rowValues = std::vector<double>();
+	pool.reset();
+}
+
+/**
+ * Splits a node in two and grows both sides, or saves the node as a rule if it cannot be split
+ * 
+ * @throws A string description of why the process failed
+ * @param node The node
+ */
+void DataMiner::Algorithm::DecisionTree::growNode(DecisionTreeNode& node) {
+	size_t size = node.end - node.begin;
+	bool pure;
+	if (regression) {
+		// Welford's updates keep the squared error accurate even when the values are far from 0
+		node.mean = 0;
+		node.squaredError = 0;
+		for (size_t i = node.begin; i < node.end; i++) {
+			double value = rowValues[rows[i]];
+			double delta = value - node.mean;
+			node.mean += delta / (i - node.begin + 1);
+			node.squaredError += delta * (value - node.mean);
+		}
+		pure = node.squaredError <= 0;
+	}
+	else {
+		node.counts.assign(numClasses, 0);
+		for (uint32_t rowClass : node.classes)
+			node.counts[rowClass]++;
+		pure = std::count(node.counts.begin(), node.counts.end(), 0) == static_cast<std::ptrdiff_t>(numClasses - 1);
+	}
+
+	if (pure || node.depth >= maxDepth || size < 2 * minLeafRows) {
+		addLeaf(node);
+		return;
+	}
+
+	std::vector<DecisionTreeSplit> splits(features.size());
+	forEachFeature(node, [this, &node, &splits](size_t feature) {
+		splits[feature] = findSplit(node, feature);
+	});
+
+	// The splits are compared in order of the features with ties going to the first one, so the tree does not depend
+	// on which thread finished first (or how many there were)
+	DecisionTreeSplit best;
+	for (size_t i = 0; i < splits.size(); i++) {
+		if (splits[i].score > best.score) {
+			best = splits[i];
+			best.feature = i;
+		}
+	}
+	if (best.feature == SIZE_MAX) {
+		addLeaf(node);
+		return;
+	}
+
+	size_t middle = partitionNode(node, best);
+	if (middle == node.begin || middle == node.end) {
+		addLeaf(node);
+		return;
+	}
+
+	const DecisionTreeFeature& feature = features[best.feature];
+	DecisionTreeCondition leftCondition(*feature.column, feature.ordered() ? DecisionTreeCondition::Comparison::lessEqual : DecisionTreeCondition::Comparison::equal);
+	DecisionTreeCondition rightCondition(*feature.column, feature.ordered() ? DecisionTreeCondition::Comparison::greater : DecisionTreeCondition::Comparison::notEqual);
+	if (feature.ordered()) {
+		leftCondition.numValue = rightCondition.numValue = best.threshold;
+	}
+	else {
+		leftCondition.strValue = rightCondition.strValue = feature.dictionary->get(best.value);
+	}
+
+	node.classes = std::vector<uint32_t>();
+	for (int side = 0; side < 2; side++) {
+		DecisionTreeNode child;
+		child.begin = side == 0 ? node.begin : middle;
+		child.end = side == 0 ? middle : node.end;
+		child.depth = node.depth + 1;
+		if (!regression) {
+			child.classes.resize(child.end - child.begin);
+			for (size_t i = child.begin; i < child.end; i++)
+				child.classes[i - child.begin] = rowClasses[rows[i]];
+		}
+		child.conditions.reserve(node.conditions.size() + 1);
+		for (const DecisionTreeCondition& condition : node.conditions)
+			child.conditions.push_back(condition);
+		child.conditions.push_back(side == 0 ? leftCondition : rightCondition);
+		growNode(child);
+	}
+}
+
+/**
+ * Saves a node as a rule, predicting the node's most common class (or mean target value for regression trees)
+ * 
+ * @param node The node
+ */
+void DataMiner::Algorithm::DecisionTree::addLeaf(DecisionTreeNode& node) {
+	rules.emplace_back(*targetColumn, columns);
+	DecisionTreeRule& rule = rules[rules.size() - 1];
+	rule.conditions = std::move(node.conditions);
+	if (regression) {
+		rule.numOutput = node.mean;
+		return;
+	}
+
+	uint32_t output = static_cast<uint32_t>(std::max_element(node.counts.begin(), node.counts.end()) - node.counts.begin());
+	if (classDictionary != nullptr)
+		rule.strOutput = classDictionary->get(output);
+	else
+		rule.numOutput = classValues[output];
+}
+
+/**
+ * Runs a function for every feature, across the threads of `pool` when the node is large enough to be worth it
+ * 
+ * @throws The error of the first feature the function failed for
+ * @param node The node the function works on
+ * @param fn The function, called with the position of each feature within `features`
+ */
+void DataMiner::Algorithm::DecisionTree::forEachFeature(const DecisionTreeNode& node, const std::function<void(size_t)>& fn) {
+	if (pool == nullptr || node.end - node.begin < minParallelRows) {
+		for (size_t i = 0; i < features.size(); i++)
+			fn(i);
+		return;
+	}
+	pool->run(features.size(), fn);
+}
+
+/**
+ * Reorders the rows of a node so that the rows on the left side of a split come first, keeping the order of the rows on
+ * each side
+ * 
+ * @throws A string description of why the process failed
+ * @param node The node
+ * @param split The split
+ * @returns The position within `rows` of the first row on the right side
+ */
+size_t DataMiner::Algorithm::DecisionTree::partitionNode(const DecisionTreeNode& node, const DecisionTreeSplit& split) {
+	// The rows keep their order on both sides, so later passes still read the columns front to back
+	const DecisionTreeFeature& feature = features[split.feature];
+	auto left = [&feature, &split](uint32_t row) {
+		return feature.ordered() ? feature.valueOf(row) <= split.value : feature.valueOf(row) == split.value;
+	};
+	return std::stable_partition(rows.begin() + node.begin, rows.begin() + node.end, left) - rows.begin();
+}
+
+/**
+ * Finds the best split of a node on a single feature, by counting the node's rows in a table of (value x class) in one
+ * pass and choosing the split from the table with `chooseSplit`
+ * 
+ * @throws A string description of why the process failed
+ * @param node The node
+ * @param feature The position of the feature within `features`
+ * @returns The best split (`feature` is set by the caller)
+ */
+Algorithm::DecisionTree::DecisionTreeSplit DataMiner::Algorithm::DecisionTree::findSplit(const DecisionTreeNode& node, size_t feature) const {
+	const DecisionTreeFeature& splitFeature = features[feature];
+	const uint32_t* nodeRows = rows.data() + node.begin;
+	const uint32_t* classes = node.classes.data();
+	size_t size = node.end - node.begin;
+
+	// Numeric tables have a row for every possible bin so that missing values need no special case
+	std::vector<uint32_t> table((splitFeature.ordered() ? Data::missingBin + 1 : splitFeature.values) * numClasses, 0);
+	uint32_t* cells = table.data();
+	size_t stride = numClasses;
+	if (splitFeature.ordered()) {
+		const uint8_t* bins = splitFeature.bins;
+		for (size_t i = 0; i < size; i++)
+			cells[bins[nodeRows[i]] * stride + classes[i]]++;
+	}
+	else {
+		const uint32_t* codes = splitFeature.codes;
+		for (size_t i = 0; i < size; i++)
+			cells[codes[nodeRows[i]] * stride + classes[i]]++;
+	}
+
+	DecisionTreeSplit split = chooseSplit(table, splitFeature, node.counts);
+	if (splitFeature.ordered())
+		split.threshold = (*splitFeature.edges)[split.value];
+	return split;
 }
 
 /**
@@ -154,15 +572,14 @@ void DataMiner::Algorithm::DecisionTree::loadProcessor(const Data& dataset, cons
 		DecisionTreeRule& rule = rules[rules.size() - 1];
 
 		// Store the line into parts for easier access
-		std::string part;
-		std::stringstream lineStream(line);
-		std::vector<std::string> parts;
-		while (std::getline(lineStream, part, ' ')) {
-			parts.push_back(part);
-		}
-
-		// Make sure the line has valid amounts of parts
-		if (parts.size() < 5 || (parts.size() - 1) % 4 != 0)
+		std::vector<bool> quoted;
+		std::vector<std::string> parts = splitLine(line, quoted);
+		auto isKeyword = [&parts, &quoted](size_t part, const char* keyword) {
+			return !quoted[part] && parts[part] == keyword;
+		};
+
+		// Make sure the line has valid amounts of parts (rules without conditions only have the output)
+		if (parts.size() < 2 || (parts.size() > 2 && (parts.size() - 1) % 4 != 0) || !isKeyword(parts.size() - 2, "then"))
 			throw "Invalid line detected in save file";
 
 		// Last part is always the value - set the value/output of the rule
@@ -180,7 +597,15 @@ void DataMiner::Algorithm::DecisionTree::loadProcessor(const Data& dataset, cons
 			const std::string& value = parts[i + 2];
 			const DataColumn& conditionColumn = dataset.getColumn(column.c_str());
 
-			rule.conditions.emplace_back(DecisionTreeCondition(conditionColumn));
+			// Conditions are only ever joined together, any other separator would change what the rule means
+			if (i + 3 < parts.size() && !isKeyword(i + 3, "and"))
+				throw "Invalid condition separator in save file (conditions can only be joined with and)";
+
+			size_t comparison = std::find(std::begin(comparisonNames), std::end(comparisonNames), parts[i + 1]) - std::begin(comparisonNames);
+			if (quoted[i + 1] || comparison == std::size(comparisonNames))
+				throw "Invalid line detected in save file";
+
+			rule.conditions.emplace_back(DecisionTreeCondition(conditionColumn, static_cast<DecisionTreeCondition::Comparison>(comparison)));
 			DecisionTreeCondition& condition = rule.conditions[rule.conditions.size() - 1];
 
 			if (conditionColumn.type == DataType::string) {
@@ -202,7 +627,36 @@ void DataMiner::Algorithm::DecisionTree::loadProcessor(const Data& dataset, cons
  * @param filename A file name to save the processor to
  */
 void DataMiner::Algorithm::DecisionTree::saveProcessor(const char* filename) {
-	throw "Unimplemented Error";
+	std::ofstream file(filename);
+
+	if (!file.is_open())
+		throw "Unable to open file";
+
+	for (const DecisionTreeRule& rule : rules) {
+		for (const DecisionTreeCondition& condition : rule.conditions) {
+			if (&condition != &rule.conditions[0])
+				file << "and ";
+			writeString(file, condition.conditionColumn.name);
+			file << ' ' << comparisonNames[static_cast<size_t>(condition.comparison)] << ' ';
+			if (condition.conditionColumn.type == DataType::string)
+				writeString(file, condition.strValue);
+			else
+				writeNumber(file, condition.numValue);
+			file << ' ';
+		}
+
+		file << "then ";
+		if (targetColumn->type == DataType::string)
+			writeString(file, rule.strOutput);
+		else
+			writeNumber(file, rule.numOutput);
+		file << std::endl;
+	}
+
+	if (!file)
+		throw "Unable to write to file";
+
+	logger->info("Decision Tree successfully saved");
 }
 
 /**
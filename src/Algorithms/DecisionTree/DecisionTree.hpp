@@ -17,6 +17,8 @@
 #pragma once
 
 #include <Processor/Processor.hpp>
+#include <Algorithms/ThreadPool.hpp>
+#include <memory>
 
 /**
  * Main data mining algorithm namespace
@@ -32,15 +34,31 @@ namespace DataMiner::Algorithm {
 		/**
 		 * Represents a single condition in a decision tree rule
 		 * 
-		 * Ie Col == value
+		 * Ie Col == value, Col != value, Col <= value or Col > value (missing numbers are never <= a value, so they
+		 * pass > conditions)
 		 */
 		struct DecisionTreeCondition {
 
+			/**
+			 * The ways a condition can compare a row's value with its value
+			 */
+			enum class Comparison {
+				equal,
+				notEqual,
+				lessEqual,
+				greater
+			};
+
 			/**
 			 * The column this condition checks with
 			 */
 			const DataColumn& conditionColumn;
 
+			/**
+			 * How the row's value is compared with the condition's value
+			 */
+			Comparison comparison;
+
 			/**
 			 * The numeric value used for checking the condition
 			 */
@@ -56,7 +74,15 @@ namespace DataMiner::Algorithm {
 			 * 
 			 * @param conditionColumn The column to check with
 			 */
-			DecisionTreeCondition(const DataColumn& conditionColumn) : conditionColumn(conditionColumn) {}
+			DecisionTreeCondition(const DataColumn& conditionColumn) : conditionColumn(conditionColumn), comparison(Comparison::equal), numValue(0) {}
+
+			/**
+			 * Creates a condition given the column for the condition and how it compares values
+			 * 
+			 * @param conditionColumn The column to check with
+			 * @param comparison How the row's value is compared with the condition's value
+			 */
+			DecisionTreeCondition(const DataColumn& conditionColumn, Comparison comparison) : conditionColumn(conditionColumn), comparison(comparison), numValue(0) {}
 
 			/**
 			 * Tests if a value passes this condition
@@ -74,7 +100,7 @@ namespace DataMiner::Algorithm {
 			 * @param value The value to check for
 			 * @returns Whether or not the value passes the condition
 			 */
-			bool testCondition(const std::string& value) const;
+			bool testCondition(std::string_view value) const;
 		};
 
 		/**
@@ -126,6 +152,139 @@ namespace DataMiner::Algorithm {
 			bool satisfiesConditions(const DataRow& row) const;
 		};
 
+		/**
+		 * A feature column the tree can split on, along with the small integer values its rows are counted by (quantile
+		 * bins for numeric columns of classification trees, dictionary codes for string columns)
+		 */
+		struct DecisionTreeFeature {
+
+			/**
+			 * The column
+			 */
+			const DataColumn* column;
+
+			/**
+			 * The quantile bin of every row of the dataset, null for string columns and regression trees
+			 */
+			const uint8_t* bins;
+
+			/**
+			 * The largest value in each quantile bin, null for string columns and regression trees
+			 */
+			const std::vector<double>* edges;
+
+			/**
+			 * The dictionary code of every row of the dataset, null for numeric columns
+			 */
+			const uint32_t* codes;
+
+			/**
+			 * The dictionary of the column, null for numeric columns
+			 */
+			const StringDictionary* dictionary;
+
+			/**
+			 * The amount of values split searches choose from (bins or dictionary codes, 0 for unbinned numeric columns),
+			 * rows with missing numbers are counted outside of these in `missingBin`
+			 */
+			size_t values;
+
+			/**
+			 * Whether the values are ordered (splits keep the values up to one of them on the left) or not (splits keep a
+			 * single value on the left)
+			 */
+			bool ordered() const {
+				return column->type == DataType::number;
+			}
+
+			/**
+			 * Returns the value a row is counted by
+			 * 
+			 * @param row The row number
+			 * @returns The bin or dictionary code of the row
+			 */
+			uint32_t valueOf(uint32_t row) const {
+				return bins != nullptr ? bins[row] : codes[row];
+			}
+		};
+
+		/**
+		 * The best split found for a node
+		 */
+		struct DecisionTreeSplit {
+
+			/**
+			 * The position of the split feature within `features`, the maximum size_t if no split was found
+			 */
+			size_t feature;
+
+			/**
+			 * The last bin on the left side for binned features, the only value on the left side for string features
+			 */
+			uint32_t value;
+
+			/**
+			 * The largest value on the left side for ordered features
+			 */
+			double threshold;
+
+			/**
+			 * How good the split is, higher is better and only splits scoring above 0 are made
+			 */
+			double score;
+
+			/**
+			 * Creates an empty split
+			 */
+			DecisionTreeSplit() : feature(SIZE_MAX), value(0), threshold(0), score(0) {}
+		};
+
+		/**
+		 * A node of the tree while it is being grown
+		 */
+		struct DecisionTreeNode {
+
+			/**
+			 * The first of the node's rows within `rows`
+			 */
+			size_t begin;
+
+			/**
+			 * One past the last of the node's rows within `rows`
+			 */
+			size_t end;
+
+			/**
+			 * The depth of the node, 0 for the root
+			 */
+			size_t depth;
+
+			/**
+			 * The class of each of the node's rows, in the same order as `rows` (classification trees only)
+			 */
+			std::vector<uint32_t> classes;
+
+			/**
+			 * The amount of the node's rows in each class (classification trees only)
+			 */
+			std::vector<uint32_t> counts;
+
+			/**
+			 * The mean target value of the node's rows (regression trees only)
+			 */
+			double mean;
+
+			/**
+			 * The sum of the squared differences between the node's target values and their mean (regression trees only)
+			 */
+			double squaredError;
+
+			/**
+			 * The conditions on the path from the root to the node
+			 */
+			std::vector<DecisionTreeCondition> conditions;
+		};
+
 		/**
 		 * The list of rules this decision tree contains
 		 */
@@ -141,12 +300,166 @@ namespace DataMiner::Algorithm {
 		 */
 		const DataColumn* targetColumn;
 
+		/**
+		 * The deepest a node may be before it is made a leaf
+		 */
+		size_t maxDepth;
+
+		/**
+		 * The fewest rows a leaf may have
+		 */
+		size_t minLeafRows;
+
+		/**
+		 * The amount of threads the tree is trained on (0 for one per core)
+		 */
+		size_t threads;
+
+		/**
+		 * The threads split searches run on (only set while the tree is grown)
+		 */
+		std::unique_ptr<ThreadPool> pool;
+
+		/**
+		 * Whether the tree predicts the mean of a numeric target (a regression tree) or the most common class of the
+		 * target (a classification tree)
+		 */
+		bool regression;
+
+		/**
+		 * The features the tree can split on (only set while the tree is grown)
+		 */
+		std::vector<DecisionTreeFeature> features;
+
+		/**
+		 * The training rows, the rows of every node are a contiguous range of these (only set while the tree is grown)
+		 */
+		std::vector<uint32_t> rows;
+
+		/**
+		 * The class of every row of the dataset, the dictionary code of the target for string targets and the position
+		 * of the value within `classValues` for numeric targets (only set while the tree is grown)
+		 */
+		std::vector<uint32_t> rowClasses;
+
+		/**
+		 * The target value of every row of the dataset (regression trees only, only set while the tree is grown)
+		 */
+		std::vector<double> rowValues;
+
+		/**
+		 * The amount of classes
+		 */
+		size_t numClasses;
+
+		/**
+		 * The value of every class of a numeric target
+		 */
+		std::vector<double> classValues;
+
+		/**
+		 * The dictionary of a string target
+		 */
+		const StringDictionary* classDictionary;
+
+		/**
+		 * Sets up `features`, and `rows` with every row which has a target value, along with the class (or target value
+		 * for regression trees) of every row
+		 * 
+		 * @throws A string description of why the process failed
+		 * @param dataset The dataset to use for the creation of the tree (its numeric columns must be binned for
+		 * classification trees)
+		 */
+		void setupTree(const Data& dataset);
+
+		/**
+		 * Grows the tree from a root holding every row of `rows`, splitting nodes with `findSplit`, then saves each leaf
+		 * as a rule (`setupTree` must have been called)
+		 * 
+		 * @throws A string description of why the process failed
+		 */
+		void growTree();
+
+		/**
+		 * Splits a node in two and grows both sides, or saves the node as a rule if it cannot be split
+		 * 
+		 * @throws A string description of why the process failed
+		 * @param node The node
+		 */
+		void growNode(DecisionTreeNode& node);
+
+		/**
+		 * Saves a node as a rule, predicting the node's most common class (or mean target value for regression trees)
+		 * 
+		 * @param node The node
+		 */
+		void addLeaf(DecisionTreeNode& node);
+
+		/**
+		 * Runs a function for every feature, across the threads of `pool` when the node is large enough to be worth it
+		 * 
+		 * @throws The error of the first feature the function failed for
+		 * @param node The node the function works on
+		 * @param fn The function, called with the position of each feature within `features`
+		 */
+		void forEachFeature(const DecisionTreeNode& node, const std::function<void(size_t)>& fn);
+
+		/**
+		 * Reorders the rows of a node so that the rows on the left side of a split come first, keeping the order of the
+		 * rows on each side
+		 * 
+		 * @throws A string description of why the process failed
+		 * @param node The node
+		 * @param split The split
+		 * @returns The position within `rows` of the first row on the right side
+		 */
+		virtual size_t partitionNode(const DecisionTreeNode& node, const DecisionTreeSplit& split);
+
+		/**
+		 * Finds the best split of a node on a single feature, by counting the node's rows in a table of (value x class)
+		 * in one pass and choosing the split from the table with `chooseSplit`
+		 * 
+		 * @throws A string description of why the process failed
+		 * @param node The node
+		 * @param feature The position of the feature within `features`
+		 * @returns The best split (`feature` is set by the caller)
+		 */
+		virtual DecisionTreeSplit findSplit(const DecisionTreeNode& node, size_t feature) const;
+
+		/**
+		 * Must choose the best split of a node from a feature's table of class counts
+		 * 
+		 * @throws A string description of why the process failed
+		 * @param table The amount of the node's rows with each value and class, `numClasses` counts per value
+		 * @param feature The feature
+		 * @param counts The amount of the node's rows in each class
+		 * @returns The best split, with a score of 0 if no split improves the node
+		 */
+		virtual DecisionTreeSplit chooseSplit(const std::vector<uint32_t>& table, const DecisionTreeFeature& feature, const std::vector<uint32_t>& counts) const = 0;
+
 	public:
 
 		/**
 		 * Creates a new decision tree algorithm
 		 */
-		DecisionTree() {}
+		DecisionTree() : targetColumn(nullptr), maxDepth(16), minLeafRows(2), threads(0), regression(false), numClasses(0), classDictionary(nullptr) {}
+
+		/**
+		 * Sets the amount of threads the tree is trained on, each searching for the best split on a different feature
+		 * 
+		 * @param threads The amount of threads (0 for one per core)
+		 */
+		void setThreads(size_t threads) {
+			this->threads = threads;
+		}
+
+		/**
+		 * Bins the numeric columns of the dataset, which the split searches count rows by
+		 * 
+		 * @throws A string with a description of why the task failed
+		 * @param dataset The dataset to train on
+		 */
+		void prepareDataset(Data& dataset);
 
 		/**
 		 * Creates a processor given a dataset to train on
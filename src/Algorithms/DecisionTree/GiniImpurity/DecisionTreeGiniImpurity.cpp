@@ -25,5 +25,79 @@ using namespace DataMiner;
  * @param dataset The dataset to use for the creation of the tree
  */
 void DataMiner::Algorithm::DecisionTreeGiniImpurity::createDecisionTree(const Data& dataset) {
+	setupTree(dataset);
+	growTree();
+}
 
+/**
+ * Chooses the split of a node which lowers the weighted Gini impurity of its rows the most
+ * 
+ * The impurity of n rows with c rows per class is 1 - sum(c^2) / n^2, so lowering the weighted impurity of a node
+ * means raising sum(c^2) / n of its sides, which is kept up to date per class as values move to the left side
+ * 
+ * @throws A string description of why the process failed
+ * @param table The amount of the node's rows with each value and class, `numClasses` counts per value
+ * @param feature The feature
+ * @param counts The amount of the node's rows in each class
+ * @returns The best split, scored by how much it lowers the impurity
+ */
+Algorithm::DecisionTree::DecisionTreeSplit DataMiner::Algorithm::DecisionTreeGiniImpurity::chooseSplit(const std::vector<uint32_t>& table, const DecisionTreeFeature& feature, const std::vector<uint32_t>& counts) const {
+	double total = 0;
+	double totalSquares = 0;
+	for (uint32_t count : counts) {
+		total += count;
+		totalSquares += static_cast<double>(count) * count;
+	}
+	double parent = totalSquares / total;
+
+	DecisionTreeSplit best;
+	std::vector<double> left(numClasses, 0);
+	double leftRows = 0;
+	double leftSquares = 0;
+	double rightSquares = totalSquares;
+	for (size_t value = 0; value < feature.values; value++) {
+		const uint32_t* cells = table.data() + value * numClasses;
+		double rows = 0;
+		for (size_t i = 0; i < numClasses; i++)
+			rows += cells[i];
+		if (rows == 0)
+			continue;
+
+		if (feature.ordered()) {
+			// Moving c rows of a class from the right to the left side
+			for (size_t i = 0; i < numClasses; i++) {
+				double moved = cells[i];
+				if (moved == 0)
+					continue;
+				double right = counts[i] - left[i];
+				leftSquares += moved * (2 * left[i] + moved);
+				rightSquares += moved * (moved - 2 * right);
+				left[i] += moved;
+			}
+			leftRows += rows;
+		}
+		else {
+			// Only this value is on the left side
+			leftSquares = 0;
+			rightSquares = 0;
+			for (size_t i = 0; i < numClasses; i++) {
+				double right = static_cast<double>(counts[i]) - cells[i];
+				leftSquares += static_cast<double>(cells[i]) * cells[i];
+				rightSquares += right * right;
+			}
+			leftRows = rows;
+		}
+
+		double rightRows = total - leftRows;
+		if (leftRows < minLeafRows || rightRows < minLeafRows)
+			continue;
+
+		double score = (leftSquares / leftRows + rightSquares / rightRows - parent) / total;
+		if (score > best.score) {
+			best.value = static_cast<uint32_t>(value);
+			best.score = score;
+		}
+	}
+
+	return best;
 }
\ No newline at end of file
@@ -25,8 +25,24 @@ namespace DataMiner::Algorithm {
 		
 	/**
 	 * Algorithm for decision trees
+	 * 
+	 * Each node counts its rows per (value x class) of every feature in one pass, over the feature's quantile bins or
+	 * dictionary codes, and the split which lowers the weighted Gini impurity the most is read off of those tables
 	 */
 	class DecisionTreeGiniImpurity : public DecisionTree {
+	protected:
+
+		/**
+		 * Chooses the split of a node which lowers the weighted Gini impurity of its rows the most
+		 * 
+		 * @throws A string description of why the process failed
+		 * @param table The amount of the node's rows with each value and class, `numClasses` counts per value
+		 * @param feature The feature
+		 * @param counts The amount of the node's rows in each class
+		 * @returns The best split, scored by how much it lowers the impurity
+		 */
+		DecisionTreeSplit chooseSplit(const std::vector<uint32_t>& table, const DecisionTreeFeature& feature, const std::vector<uint32_t>& counts) const;
+
 	public:
 
 		/**
@@ -15,9 +15,15 @@
 */
 
 #include "DecisionTreeInformationGain.hpp"
+#include <algorithm>
 
 using namespace DataMiner;
 
+/**
+ * The size of the n * log2(n) table, counts up to this size cover all but the largest nodes
+ */
+static const size_t tableSize = 1 << 20;
+
 /**
  * Create a decision tree based using the Information Gain splitting method
  * 
@@ -25,5 +31,85 @@ using namespace DataMiner;
  * @param dataset The dataset to use for the creation of the tree
  */
 void DataMiner::Algorithm::DecisionTreeGiniInformationGain::createDecisionTree(const Data& dataset) {
+	nLogN.resize(std::min(dataset.numRows() + 1, tableSize));
+	for (size_t n = 1; n < nLogN.size(); n++)
+		nLogN[n] = n * std::log2(static_cast<double>(n));
+
+	setupTree(dataset);
+	growTree();
+	nLogN = std::vector<double>();
+}
+
+/**
+ * Chooses the split of a node which gains the most information (lowers the weighted entropy of its rows the most)
+ * 
+ * The entropy of n rows with c rows per class is log2(n) - sum(c * log2(c)) / n, so the weighted entropy of a side is
+ * n * log2(n) - sum(c * log2(c)), where the sums of both sides are kept up to date per class as values move to the left
+ * side
+ * 
+ * @throws A string description of why the process failed
+ * @param table The amount of the node's rows with each value and class, `numClasses` counts per value
+ * @param feature The feature
+ * @param counts The amount of the node's rows in each class
+ * @returns The best split, scored by its information gain in bits
+ */
+Algorithm::DecisionTree::DecisionTreeSplit DataMiner::Algorithm::DecisionTreeGiniInformationGain::chooseSplit(const std::vector<uint32_t>& table, const DecisionTreeFeature& feature, const std::vector<uint32_t>& counts) const {
+	double total = 0;
+	double totalLogs = 0;
+	for (uint32_t count : counts) {
+		total += count;
+		totalLogs += countLog(count);
+	}
+	double parent = countLog(total) - totalLogs;
+
+	DecisionTreeSplit best;
+	std::vector<double> left(numClasses, 0);
+	double leftRows = 0;
+	double leftLogs = 0;
+	double rightLogs = totalLogs;
+	for (size_t value = 0; value < feature.values; value++) {
+		const uint32_t* cells = table.data() + value * numClasses;
+		double rows = 0;
+		for (size_t i = 0; i < numClasses; i++)
+			rows += cells[i];
+		if (rows == 0)
+			continue;
+
+		if (feature.ordered()) {
+			// Moving c rows of a class from the right to the left side only changes that class's terms
+			for (size_t i = 0; i < numClasses; i++) {
+				double moved = cells[i];
+				if (moved == 0)
+					continue;
+				double right = counts[i] - left[i];
+				leftLogs += countLog(left[i] + moved) - countLog(left[i]);
+				rightLogs += countLog(right - moved) - countLog(right);
+				left[i] += moved;
+			}
+			leftRows += rows;
+		}
+		else {
+			// Only this value is on the left side
+			leftLogs = 0;
+			rightLogs = 0;
+			for (size_t i = 0; i < numClasses; i++) {
+				leftLogs += countLog(cells[i]);
+				rightLogs += countLog(static_cast<double>(counts[i]) - cells[i]);
+			}
+			leftRows = rows;
+		}
+
+		double rightRows = total - leftRows;
+		if (leftRows < minLeafRows || rightRows < minLeafRows)
+			continue;
+
+		double children = countLog(leftRows) - leftLogs + countLog(rightRows) - rightLogs;
+		double score = (parent - children) / total;
+		if (score > best.score) {
+			best.value = static_cast<uint32_t>(value);
+			best.score = score;
+		}
+	}
 
+	return best;
 }
\ No newline at end of file
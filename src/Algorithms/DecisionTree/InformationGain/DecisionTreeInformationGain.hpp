@@ -17,6 +17,7 @@
 #pragma once
 
 #include <Algorithms/DecisionTree/DecisionTree.hpp>
+#include <cmath>
 
 /**
  * Main data mining namespace
@@ -25,8 +26,41 @@ namespace DataMiner::Algorithm {
 		
 	/**
 	 * Algorithm for decision trees
+	 * 
+	 * Splits are chosen from the same per node class count tables as the Gini Impurity method, entropies are worked out
+	 * from the integer counts through a table of n * log2(n) so that scanning a split costs no logarithms
 	 */
 	class DecisionTreeGiniInformationGain : public DecisionTree {
+	private:
+
+		/**
+		 * n * log2(n) for every n below the size of the table (0 for n = 0)
+		 */
+		std::vector<double> nLogN;
+
+		/**
+		 * Returns n * log2(n), from the table when n is small enough
+		 * 
+		 * @param n The count
+		 * @returns n * log2(n)
+		 */
+		double countLog(double n) const {
+			return n < nLogN.size() ? nLogN[static_cast<size_t>(n)] : n * std::log2(n);
+		}
+
+	protected:
+
+		/**
+		 * Chooses the split of a node which gains the most information (lowers the weighted entropy of its rows the most)
+		 * 
+		 * @throws A string description of why the process failed
+		 * @param table The amount of the node's rows with each value and class, `numClasses` counts per value
+		 * @param feature The feature
+		 * @param counts The amount of the node's rows in each class
+		 * @returns The best split, scored by its information gain in bits
+		 */
+		DecisionTreeSplit chooseSplit(const std::vector<uint32_t>& table, const DecisionTreeFeature& feature, const std::vector<uint32_t>& counts) const;
+
 	public:
 
 		/**
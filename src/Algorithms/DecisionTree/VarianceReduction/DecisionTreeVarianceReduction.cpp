@@ -15,9 +15,29 @@
 */
 
 #include "DecisionTreeVarianceReduction.hpp"
+#include <algorithm>
+#include <cmath>
 
 using namespace DataMiner;
 
+/**
+ * Helper function to call a function with the values of a numeric feature in their storage type
+ * 
+ * @param numbers The values of the feature
+ * @param storage The storage type of the values
+ * @param fn The function, called with a pointer to the values
+ * @returns What the function returns
+ */
+template <typename Fn> static auto visitFeature(const void* numbers, NumberStorage storage, const Fn& fn) {
+	switch (storage) {
+		case NumberStorage::float32: return fn(static_cast<const float*>(numbers));
+		case NumberStorage::int32: return fn(static_cast<const int32_t*>(numbers));
+		case NumberStorage::int16: return fn(static_cast<const int16_t*>(numbers));
+		case NumberStorage::int8: return fn(static_cast<const int8_t*>(numbers));
+		default: return fn(static_cast<const double*>(numbers));
+	}
+}
+
 /**
  * Create a decision tree based using the Variance Reduction splitting method
  * 
@@ -25,5 +45,199 @@ using namespace DataMiner;
  * @param dataset The dataset to use for the creation of the tree
  */
 void DataMiner::Algorithm::DecisionTreeVarianceReduction::createDecisionTree(const Data& dataset) {
+	setupTree(dataset);
+
+	// Rows without a target value are left out of the orders, like they are left out of `rows`
+	sortedRows.assign(features.size(), {});
+	featureNumbers.assign(features.size(), nullptr);
+	for (size_t i = 0; i < features.size(); i++) {
+		if (!features[i].ordered())
+			continue;
+
+		size_t column = 0;
+		while (&dataset.getColumn(column) != features[i].column)
+			column++;
+
+		const std::vector<uint32_t>& order = dataset.getSortedRows(column);
+		sortedRows[i].reserve(rows.size());
+		for (uint32_t row : order)
+			if (!std::isnan(rowValues[row]))
+				sortedRows[i].push_back(row);
+
+		switch (features[i].column->storage) {
+			case NumberStorage::float32: featureNumbers[i] = dataset.getNumbers<float>(column); break;
+			case NumberStorage::int32: featureNumbers[i] = dataset.getNumbers<int32_t>(column); break;
+			case NumberStorage::int16: featureNumbers[i] = dataset.getNumbers<int16_t>(column); break;
+			case NumberStorage::int8: featureNumbers[i] = dataset.getNumbers<int8_t>(column); break;
+			default: featureNumbers[i] = dataset.getNumbers<double>(column); break;
+		}
+	}
+	leftRows.assign(dataset.numRows(), 0);
+
+	growTree();
+
+	sortedRows = std::vector<std::vector<uint32_t>>();
+	featureNumbers.clear();
+	leftRows = std::vector<uint8_t>();
+}
+
+/**
+ * Sorts the rows of the dataset by its numeric columns, which the split searches walk
+ * 
+ * @throws A string with a description of why the task failed
+ * @param dataset The dataset to train on
+ */
+void DataMiner::Algorithm::DecisionTreeVarianceReduction::prepareDataset(Data& dataset) {
+	dataset.sortNumericColumns();
+}
+
+/**
+ * Finds the split of a node on a single feature which reduces the variance of its target values the most
+ * 
+ * Splitting n rows into l rows on the left and r on the right reduces their squared error by l * r / n times the
+ * squared difference of the sides' means, string features keep one value on the left side and are scored this way from
+ * a table of the row count and target sum of each value, counted in one pass
+ * 
+ * @throws A string description of why the process failed
+ * @param node The node
+ * @param feature The position of the feature within `features`
+ * @returns The best split, scored by how much it reduces the variance
+ */
+Algorithm::DecisionTree::DecisionTreeSplit DataMiner::Algorithm::DecisionTreeVarianceReduction::findSplit(const DecisionTreeNode& node, size_t feature) const {
+	const DecisionTreeFeature& splitFeature = features[feature];
+	if (splitFeature.ordered()) {
+		return visitFeature(featureNumbers[feature], splitFeature.column->storage, [this, &node, feature](const auto* values) {
+			return findThreshold(node, feature, values);
+		});
+	}
+
+	// Differences from the node's mean are summed, so the other side's sum is just the negative of this side's
+	std::vector<uint32_t> counts(splitFeature.values, 0);
+	std::vector<double> sums(splitFeature.values, 0);
+	const uint32_t* codes = splitFeature.codes;
+	for (size_t i = node.begin; i < node.end; i++) {
+		uint32_t row = rows[i];
+		counts[codes[row]]++;
+		sums[codes[row]] += rowValues[row] - node.mean;
+	}
+
+	DecisionTreeSplit best;
+	double size = static_cast<double>(node.end - node.begin);
+	for (size_t value = 0; value < splitFeature.values; value++) {
+		double left = counts[value];
+		double right = size - left;
+		if (left < minLeafRows || right < minLeafRows)
+			continue;
+
+		double score = sums[value] * sums[value] / (left * right);
+		if (score > best.score) {
+			best.value = static_cast<uint32_t>(value);
+			best.score = score;
+		}
+	}
+
+	return best;
+}
+
+/**
+ * Finds the threshold of a numeric feature which reduces the variance of a node's target values the most
+ * 
+ * The node's rows are walked in order of the feature once, moving each row to the left side of the running sums, and
+ * every threshold between two distinct values is scored from the sums alone
+ * 
+ * @param node The node
+ * @param feature The position of the feature within `features`
+ * @param values The values of the feature
+ * @returns The best split
+ */
+template <typename T> Algorithm::DecisionTree::DecisionTreeSplit DataMiner::Algorithm::DecisionTreeVarianceReduction::findThreshold(const DecisionTreeNode& node, size_t feature, const T* values) const {
+	const uint32_t* order = sortedRows[feature].data() + node.begin;
+	size_t size = node.end - node.begin;
+	double total = static_cast<double>(size);
+	double sum = node.mean * total;
+	double squares = node.squaredError + sum * node.mean;
+
+	DecisionTreeSplit best;
+	double leftSum = 0;
+	double leftSquares = 0;
+	double compensation = 0;
+	for (size_t i = 0; i < size; i++) {
+		// Rows with missing values come last and always stay on the right side
+		T value = values[order[i]];
+		if (isMissingNumber(value))
+			break;
+
+		double target = rowValues[order[i]];
+		if (stable) {
+			double term = (target - node.mean) - compensation;
+			double next = leftSum + term;
+			compensation = (next - leftSum) - term;
+			leftSum = next;
+		}
+		else {
+			leftSum += target;
+			leftSquares += target * target;
+		}
+
+		// Rows with the same value cannot be split apart
+		if (i + 1 < size && values[order[i + 1]] == value)
+			continue;
+
+		double left = static_cast<double>(i + 1);
+		double right = total - left;
+		if (left < minLeafRows || right < minLeafRows)
+			continue;
+
+		double score;
+		if (stable) {
+			score = leftSum * leftSum / (left * right);
+		}
+		else {
+			double rightSum = sum - leftSum;
+			double leftError = leftSquares - leftSum * leftSum / left;
+			double rightError = (squares - leftSquares) - rightSum * rightSum / right;
+			score = (node.squaredError - leftError - rightError) / total;
+		}
+
+		if (score > best.score) {
+			best.threshold = widenNumber(value);
+			best.score = score;
+		}
+	}
+
+	return best;
+}
+
+/**
+ * Reorders the rows of a node so that the rows on the left side of a split come first, in `rows` as well as in the
+ * order of every numeric feature
+ * 
+ * @throws A string description of why the process failed
+ * @param node The node
+ * @param split The split
+ * @returns The position within `rows` of the first row on the right side
+ */
+size_t DataMiner::Algorithm::DecisionTreeVarianceReduction::partitionNode(const DecisionTreeNode& node, const DecisionTreeSplit& split) {
+	const DecisionTreeFeature& feature = features[split.feature];
+	if (feature.ordered()) {
+		visitFeature(featureNumbers[split.feature], feature.column->storage, [this, &node, &split](const auto* values) {
+			for (size_t i = node.begin; i < node.end; i++)
+				leftRows[rows[i]] = !isMissingNumber(values[rows[i]]) && widenNumber(values[rows[i]]) <= split.threshold;
+		});
+	}
+	else {
+		for (size_t i = node.begin; i < node.end; i++)
+			leftRows[rows[i]] = feature.codes[rows[i]] == split.value;
+	}
 
+	// Partitioning keeps the order of each side, so every feature's order stays sorted within both children
+	auto left = [this](uint32_t row) {
+		return leftRows[row] != 0;
+	};
+	forEachFeature(node, [this, &node, &left](size_t feature) {
+		std::vector<uint32_t>& order = sortedRows[feature];
+		if (!order.empty())
+			std::stable_partition(order.begin() + node.begin, order.begin() + node.end, left);
+	});
+	return std::stable_partition(rows.begin() + node.begin, rows.begin() + node.end, left) - rows.begin();
 }
\ No newline at end of file
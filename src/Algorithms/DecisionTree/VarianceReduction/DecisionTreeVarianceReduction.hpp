@@ -25,10 +25,98 @@ namespace DataMiner::Algorithm {
 		
 	/**
 	 * Algorithm for decision trees
+	 * 
+	 * Grows regression trees for numeric targets, each node's rows are kept in order of every numeric feature so a split
+	 * search walks each feature once with running sums of the target, which scores every threshold in constant time
 	 */
 	class DecisionTreeVarianceReduction : public DecisionTree {
+	private:
+
+		/**
+		 * Whether split searches sum the differences between the target values and the node's mean with compensated
+		 * (Kahan) sums, rather than summing the target values and their squares (slower, but accurate for targets whose
+		 * values are far larger than their spread)
+		 */
+		bool stable;
+
+		/**
+		 * The training rows ordered by the values of each numeric feature (empty for string features), the rows of every
+		 * node are the same range of these as of `rows`
+		 */
+		std::vector<std::vector<uint32_t>> sortedRows;
+
+		/**
+		 * The values of each numeric feature in the column's storage type (null for string features)
+		 */
+		std::vector<const void*> featureNumbers;
+
+		/**
+		 * Whether each row of the dataset is on the left side of the split being made
+		 */
+		std::vector<uint8_t> leftRows;
+
+		/**
+		 * Finds the threshold of a numeric feature which reduces the variance of a node's target values the most
+		 * 
+		 * @param node The node
+		 * @param feature The position of the feature within `features`
+		 * @param values The values of the feature
+		 * @returns The best split
+		 */
+		template <typename T> DecisionTreeSplit findThreshold(const DecisionTreeNode& node, size_t feature, const T* values) const;
+
+	protected:
+
+		/**
+		 * Finds the split of a node on a single feature which reduces the variance of its target values the most
+		 * 
+		 * @throws A string description of why the process failed
+		 * @param node The node
+		 * @param feature The position of the feature within `features`
+		 * @returns The best split, scored by how much it reduces the variance
+		 */
+		DecisionTreeSplit findSplit(const DecisionTreeNode& node, size_t feature) const;
+
+		/**
+		 * Reorders the rows of a node so that the rows on the left side of a split come first, in `rows` as well as in
+		 * the order of every numeric feature
+		 * 
+		 * @throws A string description of why the process failed
+		 * @param node The node
+		 * @param split The split
+		 * @returns The position within `rows` of the first row on the right side
+		 */
+		size_t partitionNode(const DecisionTreeNode& node, const DecisionTreeSplit& split);
+
+		/**
+		 * Regression trees have no class counts, their splits are only ever found by `findSplit`
+		 * 
+		 * @returns An empty split
+		 */
+		DecisionTreeSplit chooseSplit(const std::vector<uint32_t>& /*table*/, const DecisionTreeFeature& /*feature*/, const std::vector<uint32_t>& /*counts*/) const {
+			return DecisionTreeSplit();
+		}
+
 	public:
 
+		/**
+		 * Creates a new variance reduction decision tree algorithm
+		 * 
+		 * @param stable Whether split searches use compensated sums of the target's differences from the node mean
+		 * instead of plain sums of the target and its squares
+		 */
+		DecisionTreeVarianceReduction(bool stable = false) : stable(stable) {
+			regression = true;
+		}
+
+		/**
+		 * Sorts the rows of the dataset by its numeric columns, which the split searches walk
+		 * 
+		 * @throws A string with a description of why the task failed
+		 * @param dataset The dataset to train on
+		 */
+		void prepareDataset(Data& dataset);
+
 		/**
 		 * Create a decision tree based using the Variance Reduction splitting method
 		 * 
@@ -0,0 +1,130 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+using namespace DataMiner;
+
+/**
+ * Starts a pool
+ * 
+ * @param threads The amount of threads loops run on, including the thread which starts them (0 for one per core)
+ */
+DataMiner::Algorithm::ThreadPool::ThreadPool(size_t threads) : job(nullptr), count(0), next(0), running(0), generation(0), stopping(false) {
+	if (threads == 0)
+		threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	for (size_t i = 1; i < threads; i++)
+		workers.emplace_back(&ThreadPool::work, this);
+}
+
+/**
+ * Stops the threads of the pool
+ */
+DataMiner::Algorithm::ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopping = true;
+	}
+	started.notify_all();
+	for (std::thread& worker : workers)
+		worker.join();
+}
+
+/**
+ * Waits for loops and helps run them (runs on each worker)
+ */
+void DataMiner::Algorithm::ThreadPool::work() {
+	size_t seen = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			started.wait(guard, [this, seen]() {
+				return stopping || generation != seen;
+			});
+			if (stopping)
+				return;
+			seen = generation;
+		}
+
+		runIterations();
+
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			running--;
+		}
+		finished.notify_all();
+	}
+}
+
+/**
+ * Runs iterations of the current loop until every iteration has been taken
+ */
+void DataMiner::Algorithm::ThreadPool::runIterations() {
+	for (size_t i = next++; i < count; i = next++) {
+		try {
+			(*job)(i);
+		}
+		catch (const char* error) {
+			errors[i] = error;
+		}
+		catch (const std::exception&) {
+			errors[i] = "Unexpected error while running in parallel";
+		}
+	}
+}
+
+/**
+ * Runs a loop across the threads of the pool, returning once every iteration is done (iterations may run in any order,
+ * so they should write their results to separate places)
+ * 
+ * @throws The error of the first iteration which failed
+ * @param iterations The amount of iterations
+ * @param fn The body of the loop, called with the number of each iteration
+ */
+void DataMiner::Algorithm::ThreadPool::run(size_t iterations, const std::function<void(size_t)>& fn) {
+	if (workers.empty() || iterations < 2) {
+		for (size_t i = 0; i < iterations; i++)
+			fn(i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		job = &fn;
+		count = iterations;
+		next = 0;
+		errors.assign(iterations, nullptr);
+		running = workers.size();
+		generation++;
+	}
+	started.notify_all();
+
+	runIterations();
+
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		finished.wait(guard, [this]() {
+			return running == 0;
+		});
+		job = nullptr;
+	}
+
+	// The first failed iteration is reported, whichever thread ran it
+	for (const char* error : errors)
+		if (error != nullptr)
+			throw error;
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Main data mining algorithm namespace
+ */
+namespace DataMiner::Algorithm {
+
+	/**
+	 * A fixed set of threads which run the iterations of parallel loops, kept alive between loops so that many small
+	 * loops (such as one per tree node) do not each pay for starting threads
+	 */
+	class ThreadPool {
+	private:
+
+		/**
+		 * The threads of the pool, besides the thread which runs the loops
+		 */
+		std::vector<std::thread> workers;
+
+		/**
+		 * Guards `job`, `count`, `running`, `generation` and `stopping`
+		 */
+		std::mutex lock;
+
+		/**
+		 * Signalled when a loop is started or the pool is stopping
+		 */
+		std::condition_variable started;
+
+		/**
+		 * Signalled when a worker is done with a loop
+		 */
+		std::condition_variable finished;
+
+		/**
+		 * The body of the loop being run, null while the pool is idle
+		 */
+		const std::function<void(size_t)>* job;
+
+		/**
+		 * The amount of iterations of the loop being run
+		 */
+		size_t count;
+
+		/**
+		 * The next iteration to be taken by a thread
+		 */
+		std::atomic<size_t> next;
+
+		/**
+		 * The amount of workers which are not done with the loop being run
+		 */
+		size_t running;
+
+		/**
+		 * The amount of loops started so far, which tells the workers a new loop is waiting
+		 */
+		size_t generation;
+
+		/**
+		 * Whether the pool is being destroyed
+		 */
+		bool stopping;
+
+		/**
+		 * The error each iteration of the loop being run failed with, null for iterations which did not fail
+		 */
+		std::vector<const char*> errors;
+
+		/**
+		 * Waits for loops and helps run them (runs on each worker)
+		 */
+		void work();
+
+		/**
+		 * Runs iterations of the current loop until every iteration has been taken
+		 */
+		void runIterations();
+
+	public:
+
+		/**
+		 * Starts a pool
+		 * 
+		 * @param threads The amount of threads loops run on, including the thread which starts them (0 for one per core)
+		 */
+		ThreadPool(size_t threads);
+
+		/**
+		 * Stops the threads of the pool
+		 */
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/**
+		 * Returns the amount of threads loops run on
+		 * 
+		 * @returns The amount of threads
+		 */
+		size_t size() const {
+			return workers.size() + 1;
+		}
+
+		/**
+		 * Runs a loop across the threads of the pool, returning once every iteration is done (iterations may run in any
+		 * order, so they should write their results to separate places)
+		 * 
+		 * @throws The error of the first iteration which failed
+		 * @param iterations The amount of iterations
+		 * @param fn The body of the loop, called with the number of each iteration
+		 */
+		void run(size_t iterations, const std::function<void(size_t)>& fn);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "ColumnAllocator.hpp"
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <stdlib.h>
+#include <sys/mman.h>
+#endif
+
+using namespace DataMiner;
+
+/**
+ * Allocator used when no other allocator was installed
+ */
+static ColumnAllocator defaultAllocator;
+
+/**
+ * Allocator used for the column buffers of new datasets (never null)
+ */
+ColumnAllocator* DataMiner::columnAllocator = &defaultAllocator;
+
+/**
+ * Allocates a buffer
+ *
+ * @throws A string with a description of why the process failed
+ * @param bytes The size of the buffer
+ * @returns The buffer (aligned to at least `alignment`), null if `bytes` is zero
+ */
+void* DataMiner::ColumnAllocator::allocate(size_t bytes) {
+	if (bytes == 0)
+		return nullptr;
+
+	// Huge pages can only back whole aligned pages, so large buffers are aligned to the huge page size
+	size_t boundary = bytes >= hugePageSize ? hugePageSize : alignment;
+#ifdef _WIN32
+	void* buffer = _aligned_malloc(bytes, boundary);
+	if (buffer == nullptr)
+		throw "Unable to allocate memory for the dataset";
+#else
+	void* buffer = nullptr;
+	if (posix_memalign(&buffer, boundary, bytes) != 0)
+		throw "Unable to allocate memory for the dataset";
+#ifdef MADV_HUGEPAGE
+	if (bytes >= hugePageSize)
+		madvise(buffer, bytes / hugePageSize * hugePageSize, MADV_HUGEPAGE);
+#endif
+#endif
+	return buffer;
+}
+
+/**
+ * Frees a buffer
+ *
+ * @param buffer The buffer (returned by `allocate` on this allocator)
+ * @param bytes The size the buffer was allocated with
+ */
+void DataMiner::ColumnAllocator::deallocate(void* buffer, size_t) {
+#ifdef _WIN32
+	_aligned_free(buffer);
+#else
+	free(buffer);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Main data mining namespace
+ */
+namespace DataMiner {
+
+	/**
+	 * Allocates the column buffers of datasets
+	 *
+	 * Every buffer starts on a cache line, and large buffers are backed by transparent huge pages where the platform
+	 * supports them. Subclasses can override the allocation (for example to place buffers on the local NUMA node) and
+	 * be installed through `columnAllocator` before datasets are loaded
+	 */
+	class ColumnAllocator {
+	public:
+
+		/**
+		 * Alignment of every buffer and of every column within a buffer
+		 */
+		static constexpr size_t alignment = 64;
+
+		/**
+		 * Size from which buffers are backed by huge pages
+		 */
+		static constexpr size_t hugePageSize = 1 << 21;
+
+		virtual ~ColumnAllocator() = default;
+
+		/**
+		 * Allocates a buffer
+		 *
+		 * @throws A string with a description of why the process failed
+		 * @param bytes The size of the buffer
+		 * @returns The buffer (aligned to at least `alignment`), null if `bytes` is zero
+		 */
+		virtual void* allocate(size_t bytes);
+
+		/**
+		 * Frees a buffer
+		 *
+		 * @param buffer The buffer (returned by `allocate` on this allocator)
+		 * @param bytes The size the buffer was allocated with
+		 */
+		virtual void deallocate(void* buffer, size_t bytes);
+
+		/**
+		 * Rounds a row count up so that a column of any element size fills whole cache lines, which keeps every column
+		 * of a buffer aligned and lets vector loads run past the last row without a scalar tail
+		 *
+		 * @param rows The amount of rows
+		 * @returns The padded amount of rows
+		 */
+		static size_t paddedRows(size_t rows) {
+			return (rows + alignment - 1) / alignment * alignment;
+		}
+	};
+
+	/**
+	 * Allocator used for the column buffers of new datasets (never null)
+	 */
+	extern ColumnAllocator* columnAllocator;
+}
\ No newline at end of file
@@ -0,0 +1,321 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "CompressedFile.hpp"
+
+#ifdef DATAMINER_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef DATAMINER_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace DataMiner;
+
+/**
+ * Size of the decompressed blocks handed to the reader
+ */
+static const size_t blockSize = 1 << 22;
+
+/**
+ * Size of the compressed reads from the file
+ */
+static const size_t inputSize = 1 << 20;
+
+/**
+ * Most decompressed blocks waiting to be read at once, which bounds the memory used when decompressing outpaces parsing
+ */
+static const size_t queueDepth = 4;
+
+/**
+ * Helper function to check whether a string ends with another string
+ *
+ * @param value The string
+ * @param suffix The ending to look for
+ * @returns Whether or not `value` ends with `suffix`
+ */
+static bool endsWith(const std::string& value, const char* suffix) {
+	std::string ending(suffix);
+	return value.size() >= ending.size() && value.compare(value.size() - ending.size(), ending.size(), ending) == 0;
+}
+
+/**
+ * Opens a compressed file and starts decompressing it
+ *
+ * @throws A string with a description of why the process failed
+ * @param filename The name of the file (the format is taken from its extension)
+ */
+DataMiner::CompressedFile::CompressedFile(const char* filename) :
+	file(filename, std::ios::binary), format(Format::gzip), finished(false), stopping(false), error(nullptr) {
+	if (endsWith(filename, ".zst"))
+		format = Format::zstd;
+	else if (!endsWith(filename, ".gz"))
+		throw "Unsupported compression format";
+
+#ifndef DATAMINER_ZLIB
+	if (format == Format::gzip)
+		throw "This build does not support gzip compressed datasets";
+#endif
+#ifndef DATAMINER_ZSTD
+	if (format == Format::zstd)
+		throw "This build does not support zstd compressed datasets";
+#endif
+
+	if (!file.is_open())
+		throw "Unable to Open File Error";
+
+	setg(nullptr, nullptr, nullptr);
+	worker = std::thread(&CompressedFile::decompress, this);
+}
+
+/**
+ * Stops decompressing and closes the file
+ */
+DataMiner::CompressedFile::~CompressedFile() {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopping = true;
+	}
+	changed.notify_all();
+	worker.join();
+}
+
+/**
+ * Checks whether a file name has the extension of a supported compression format
+ *
+ * @param filename The name of the file
+ * @returns Whether or not the file is compressed
+ */
+bool DataMiner::CompressedFile::isCompressed(const std::string& filename) {
+	return endsWith(filename, ".gz") || endsWith(filename, ".zst");
+}
+
+/**
+ * Checks whether decompression failed, which the stream itself only reports as an early end of file
+ *
+ * @throws A string with a description of why decompression failed
+ */
+void DataMiner::CompressedFile::checkError() {
+	std::lock_guard<std::mutex> guard(lock);
+	if (error != nullptr)
+		throw error;
+}
+
+/**
+ * Decompresses the whole file into blocks (runs on the worker thread)
+ */
+void DataMiner::CompressedFile::decompress() {
+	const char* failure = nullptr;
+	try {
+		if (format == Format::gzip)
+			decompressGzip();
+		else
+			decompressZstd();
+	}
+	catch (const char* thrown) {
+		failure = thrown;
+	}
+	catch (const std::exception&) {
+		failure = "Unexpected error while decompressing the dataset";
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		finished = true;
+		error = failure;
+	}
+	changed.notify_all();
+}
+
+/**
+ * Hands a decompressed block to the reader, waiting while the queue is full
+ *
+ * @param block The block
+ * @returns Whether or not the reader still wants more blocks
+ */
+bool DataMiner::CompressedFile::push(std::vector<char>&& block) {
+	std::unique_lock<std::mutex> guard(lock);
+	changed.wait(guard, [this]() {
+		return stopping || ready.size() < queueDepth;
+	});
+	if (stopping)
+		return false;
+	ready.push_back(std::move(block));
+	guard.unlock();
+	changed.notify_all();
+	return true;
+}
+
+/**
+ * Moves on to the next decompressed block, waiting for the worker if needed
+ *
+ * @returns The first byte of the block, or end of file once there are no blocks left
+ */
+CompressedFile::int_type DataMiner::CompressedFile::underflow() {
+	if (gptr() < egptr())
+		return traits_type::to_int_type(*gptr());
+
+	std::unique_lock<std::mutex> guard(lock);
+	changed.wait(guard, [this]() {
+		return finished || !ready.empty();
+	});
+	if (ready.empty())
+		return traits_type::eof();
+
+	current = std::move(ready.front());
+	ready.pop_front();
+	guard.unlock();
+	changed.notify_all();
+
+	setg(current.data(), current.data(), current.data() + current.size());
+	return traits_type::to_int_type(*gptr());
+}
+
+/**
+ * Decompresses a gzip file into blocks
+ *
+ * @throws A string with a description of why the process failed
+ */
+void DataMiner::CompressedFile::decompressGzip() {
+#ifdef DATAMINER_ZLIB
+	z_stream stream = {};
+	// 32 lets zlib detect gzip and zlib headers on its own
+	if (inflateInit2(&stream, 15 + 32) != Z_OK)
+		throw "Unable to start decompressing the dataset";
+
+	std::vector<char> input(inputSize);
+	std::vector<char> block(blockSize);
+	stream.next_out = reinterpret_cast<Bytef*>(block.data());
+	stream.avail_out = static_cast<uInt>(block.size());
+	bool inputDone = false;
+	bool filled = false;
+	bool streamEnded = false;
+
+	try {
+		while (true) {
+			if (stream.avail_in == 0 && !inputDone) {
+				file.read(input.data(), input.size());
+				if (file.bad())
+					throw "Unable to read the compressed dataset";
+				stream.next_in = reinterpret_cast<Bytef*>(input.data());
+				stream.avail_in = static_cast<uInt>(file.gcount());
+				inputDone = stream.avail_in == 0;
+			}
+
+			// A full block may have left output behind, so only stop once inflate had room to spare
+			if (stream.avail_in == 0 && inputDone && !filled)
+				break;
+
+			// A file may hold several gzip members one after the other
+			if (streamEnded) {
+				filled = false;
+				if (stream.avail_in == 0)
+					continue;
+				inflateReset(&stream);
+				streamEnded = false;
+			}
+
+			int result = inflate(&stream, Z_NO_FLUSH);
+			if (result == Z_STREAM_END)
+				streamEnded = true;
+			else if (result != Z_OK && result != Z_BUF_ERROR)
+				throw "The compressed dataset is corrupt";
+
+			filled = stream.avail_out == 0;
+			if (filled) {
+				if (!push(std::move(block)))
+					break;
+				block.assign(blockSize, 0);
+				stream.next_out = reinterpret_cast<Bytef*>(block.data());
+				stream.avail_out = static_cast<uInt>(block.size());
+			}
+		}
+
+		block.resize(block.size() - stream.avail_out);
+		if (!block.empty())
+			push(std::move(block));
+		if (inputDone && !streamEnded)
+			throw "The compressed dataset is truncated";
+	}
+	catch (const char*) {
+		inflateEnd(&stream);
+		throw;
+	}
+	inflateEnd(&stream);
+#endif
+}
+
+/**
+ * Decompresses a zstd file into blocks
+ *
+ * @throws A string with a description of why the process failed
+ */
+void DataMiner::CompressedFile::decompressZstd() {
+#ifdef DATAMINER_ZSTD
+	ZSTD_DCtx* context = ZSTD_createDCtx();
+	if (context == nullptr)
+		throw "Unable to start decompressing the dataset";
+
+	std::vector<char> input(inputSize);
+	std::vector<char> block(blockSize);
+	ZSTD_inBuffer in = {input.data(), 0, 0};
+	ZSTD_outBuffer out = {block.data(), block.size(), 0};
+	bool inputDone = false;
+	bool filled = false;
+	size_t frameRemaining = 0;
+
+	try {
+		while (true) {
+			if (in.pos == in.size && !inputDone) {
+				file.read(input.data(), input.size());
+				if (file.bad())
+					throw "Unable to read the compressed dataset";
+				in.size = static_cast<size_t>(file.gcount());
+				in.pos = 0;
+				inputDone = in.size == 0;
+			}
+
+			// A full block may have left output behind, so only stop once zstd had room to spare
+			if (in.pos == in.size && inputDone && !filled)
+				break;
+
+			frameRemaining = ZSTD_decompressStream(context, &out, &in);
+			if (ZSTD_isError(frameRemaining))
+				throw "The compressed dataset is corrupt";
+
+			filled = out.pos == out.size;
+			if (filled) {
+				if (!push(std::move(block)))
+					break;
+				block.assign(blockSize, 0);
+				out = {block.data(), block.size(), 0};
+			}
+		}
+
+		block.resize(out.pos);
+		if (!block.empty())
+			push(std::move(block));
+		if (inputDone && frameRemaining != 0)
+			throw "The compressed dataset is truncated";
+	}
+	catch (const char*) {
+		ZSTD_freeDCtx(context);
+		throw;
+	}
+	ZSTD_freeDCtx(context);
+#endif
+}
\ No newline at end of file
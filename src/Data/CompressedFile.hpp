@@ -0,0 +1,170 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+/**
+ * Main data mining namespace
+ */
+namespace DataMiner {
+
+	/**
+	 * Reads a gzip (.gz) or zstd (.zst) compressed file as a stream of its decompressed bytes
+	 *
+	 * Decompression runs on its own thread, which hands fixed size blocks to the reader through a small bounded
+	 * queue, so decompressing the next blocks overlaps with parsing the current one
+	 */
+	class CompressedFile : public std::streambuf {
+	public:
+
+		/**
+		 * The supported compression formats
+		 */
+		enum class Format {
+			gzip,
+			zstd
+		};
+
+	private:
+
+		/**
+		 * The compressed file
+		 */
+		std::ifstream file;
+
+		/**
+		 * The compression format of the file
+		 */
+		Format format;
+
+		/**
+		 * Decompressed blocks which have not been read yet
+		 */
+		std::deque<std::vector<char>> ready;
+
+		/**
+		 * The block currently being read
+		 */
+		std::vector<char> current;
+
+		/**
+		 * Guards `ready`, `finished`, `stopping` and `error`
+		 */
+		std::mutex lock;
+
+		/**
+		 * Signalled whenever a block is added to or taken from `ready`, or the worker stops
+		 */
+		std::condition_variable changed;
+
+		/**
+		 * Whether the worker has decompressed the whole file (or failed)
+		 */
+		bool finished;
+
+		/**
+		 * Whether the reader is gone and the worker should stop early
+		 */
+		bool stopping;
+
+		/**
+		 * The error the worker failed with, null if there was none
+		 */
+		const char* error;
+
+		/**
+		 * The thread decompressing the file
+		 */
+		std::thread worker;
+
+		/**
+		 * Decompresses the whole file into blocks (runs on the worker thread)
+		 */
+		void decompress();
+
+		/**
+		 * Decompresses a gzip file into blocks
+		 *
+		 * @throws A string with a description of why the process failed
+		 */
+		void decompressGzip();
+
+		/**
+		 * Decompresses a zstd file into blocks
+		 *
+		 * @throws A string with a description of why the process failed
+		 */
+		void decompressZstd();
+
+		/**
+		 * Hands a decompressed block to the reader, waiting while the queue is full
+		 *
+		 * @param block The block
+		 * @returns Whether or not the reader still wants more blocks
+		 */
+		bool push(std::vector<char>&& block);
+
+	protected:
+
+		/**
+		 * Moves on to the next decompressed block, waiting for the worker if needed
+		 *
+		 * @returns The first byte of the block, or end of file once there are no blocks left
+		 */
+		int_type underflow() override;
+
+	public:
+
+		/**
+		 * Opens a compressed file and starts decompressing it
+		 *
+		 * @throws A string with a description of why the process failed
+		 * @param filename The name of the file (the format is taken from its extension)
+		 */
+		CompressedFile(const char* filename);
+
+		/**
+		 * Stops decompressing and closes the file
+		 */
+		~CompressedFile();
+
+		CompressedFile(const CompressedFile&) = delete;
+		CompressedFile& operator=(const CompressedFile&) = delete;
+
+		/**
+		 * Checks whether decompression failed, which the stream itself only reports as an early end of file
+		 *
+		 * @throws A string with a description of why decompression failed
+		 */
+		void checkError();
+
+		/**
+		 * Checks whether a file name has the extension of a supported compression format
+		 *
+		 * @param filename The name of the file
+		 * @returns Whether or not the file is compressed
+		 */
+		static bool isCompressed(const std::string& filename);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,412 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "CsvScanner.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define DATAMINER_X86
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace DataMiner;
+
+/**
+ * Size of the blocks the scanner classifies at once (one bit per byte in a 64 bit mask)
+ */
+static const size_t blockSize = 64;
+
+/**
+ * Positions of the structural characters in a single block
+ */
+struct BlockMasks {
+	/**
+	 * Positions of quote characters
+	 */
+	uint64_t quotes;
+
+	/**
+	 * Positions of commas
+	 */
+	uint64_t commas;
+
+	/**
+	 * Positions of newlines
+	 */
+	uint64_t newlines;
+};
+
+/**
+ * Helper function to find the index of the lowest set bit
+ *
+ * @param mask A mask with at least one bit set
+ * @returns The index of the lowest set bit
+ */
+static unsigned int trailingZeros(uint64_t mask) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, mask);
+	return index;
+#else
+	return __builtin_ctzll(mask);
+#endif
+}
+
+/**
+ * Helper function to find the amount of zero bits above the highest set bit
+ *
+ * @param mask A mask with at least one bit set
+ * @returns The amount of zero bits above the highest set bit
+ */
+static unsigned int leadingZeros(uint64_t mask) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse64(&index, mask);
+	return 63 - index;
+#else
+	return __builtin_clzll(mask);
+#endif
+}
+
+/**
+ * Helper function to count the set bits of a mask
+ *
+ * @param mask The mask
+ * @returns The amount of set bits
+ */
+static unsigned int popCount(uint64_t mask) {
+#ifdef _MSC_VER
+	return static_cast<unsigned int>(__popcnt64(mask));
+#else
+	return __builtin_popcountll(mask);
+#endif
+}
+
+/**
+ * Helper function which sets every bit to the xor of all bits at or below it, turning a mask of quotes into a mask
+ * of the bytes inside of quotes (opening quotes included, closing quotes excluded)
+ *
+ * @param mask The quote mask
+ * @returns The inside of quotes mask
+ */
+static uint64_t prefixXor(uint64_t mask) {
+	mask ^= mask << 1;
+	mask ^= mask << 2;
+	mask ^= mask << 4;
+	mask ^= mask << 8;
+	mask ^= mask << 16;
+	mask ^= mask << 32;
+	return mask;
+}
+
+#ifndef DATAMINER_X86
+
+/**
+ * Classifies 64 bytes one at a time
+ *
+ * @param block The first of the 64 bytes
+ * @returns The structural character masks of the block
+ */
+static BlockMasks classifyScalar(const char* block) {
+	BlockMasks masks = {0, 0, 0};
+	for (size_t i = 0; i < blockSize; i++) {
+		uint64_t bit = 1ull << i;
+		if (block[i] == '"') masks.quotes |= bit;
+		if (block[i] == ',') masks.commas |= bit;
+		if (block[i] == '\n') masks.newlines |= bit;
+	}
+	return masks;
+}
+
+#else
+
+/**
+ * Classifies 64 bytes using four 16 byte SSE2 compares per character
+ *
+ * @param block The first of the 64 bytes
+ * @returns The structural character masks of the block
+ */
+static BlockMasks classifySse2(const char* block) {
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i comma = _mm_set1_epi8(',');
+	const __m128i newline = _mm_set1_epi8('\n');
+
+	BlockMasks masks = {0, 0, 0};
+	for (size_t i = 0; i < blockSize; i += 16) {
+		__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+		masks.quotes |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, quote)))) << i;
+		masks.commas |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, comma)))) << i;
+		masks.newlines |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline)))) << i;
+	}
+	return masks;
+}
+
+/**
+ * Classifies 64 bytes using two 32 byte AVX2 compares per character
+ *
+ * @param block The first of the 64 bytes
+ * @returns The structural character masks of the block
+ */
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx2")))
+#endif
+static BlockMasks classifyAvx2(const char* block) {
+	const __m256i quote = _mm256_set1_epi8('"');
+	const __m256i comma = _mm256_set1_epi8(',');
+	const __m256i newline = _mm256_set1_epi8('\n');
+
+	BlockMasks masks = {0, 0, 0};
+	for (size_t i = 0; i < blockSize; i += 32) {
+		__m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+		masks.quotes |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, quote)))) << i;
+		masks.commas |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, comma)))) << i;
+		masks.newlines |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline)))) << i;
+	}
+	return masks;
+}
+
+#endif
+
+/**
+ * Helper function to pick the fastest block classifier the cpu supports
+ *
+ * @returns The block classifier
+ */
+static BlockMasks (*selectClassifier())(const char*) {
+#ifdef DATAMINER_X86
+#if defined(__GNUC__) || defined(__clang__)
+	if (__builtin_cpu_supports("avx2"))
+		return classifyAvx2;
+#endif
+	return classifySse2;
+#else
+	return classifyScalar;
+#endif
+}
+
+/**
+ * The block classifier used by all scanners
+ */
+static BlockMasks (*const classify)(const char*) = selectClassifier();
+
+/**
+ * Helper function to classify the block starting at a position, bytes past the end of the data are never read and
+ * never reported
+ *
+ * @param block The first byte of the block
+ * @param end One past the last byte of the data
+ * @returns The structural character masks of the block
+ */
+static BlockMasks classifyBlock(const char* block, const char* end) {
+	size_t remaining = end - block;
+	if (remaining >= blockSize)
+		return classify(block);
+
+	char padded[blockSize] = {};
+	std::memcpy(padded, block, remaining);
+	return classify(padded);
+}
+
+/**
+ * Creates a scanner over a block of memory, which must begin at the start of a row
+ *
+ * @param begin The first byte of the block
+ * @param end One past the last byte of the block
+ */
+DataMiner::CsvScanner::CsvScanner(const char* begin, const char* end) :
+	cursor(begin), end(end), blockBase(begin), pending(0), inQuotes(false), rowOpen(false) {
+	if (begin < end)
+		loadBlock();
+}
+
+/**
+ * Classifies the next 64 byte block and stores its delimiters into `pending`
+ */
+void DataMiner::CsvScanner::loadBlock() {
+	BlockMasks masks = classifyBlock(blockBase, end);
+	uint64_t quoted = prefixXor(masks.quotes) ^ (inQuotes ? ~0ull : 0ull);
+	inQuotes = (quoted >> 63) != 0;
+	pending = (masks.commas | masks.newlines) & ~quoted;
+}
+
+/**
+ * Reads the next field
+ *
+ * Quotes around the field are removed and escaped quotes are unescaped, the returned view is only valid until the
+ * next call
+ *
+ * @param field The field that was read
+ * @param lastInRow Set to whether the field was the last one in its row
+ * @returns Whether or not there was a field left to read
+ */
+bool DataMiner::CsvScanner::nextField(std::string_view& field, bool& lastInRow) {
+	if (cursor >= end && !rowOpen)
+		return false;
+
+	while (pending == 0 && blockBase + blockSize < end) {
+		blockBase += blockSize;
+		loadBlock();
+	}
+
+	const char* fieldBegin = cursor;
+	const char* delimiter = end;
+	if (pending != 0) {
+		delimiter = blockBase + trailingZeros(pending);
+		pending &= pending - 1;
+	}
+
+	lastInRow = delimiter == end || *delimiter == '\n';
+	rowOpen = !lastInRow;
+	cursor = delimiter == end ? end : delimiter + 1;
+
+	const char* fieldEnd = delimiter;
+	if (lastInRow && fieldEnd > fieldBegin && fieldEnd[-1] == '\r')
+		fieldEnd--;
+
+	field = std::string_view(fieldBegin, fieldEnd - fieldBegin);
+	if (field.size() < 2 || field.front() != '"' || field.back() != '"')
+		return true;
+
+	// Quoted field, drop the surrounding quotes and collapse escaped ("") quotes
+	field = field.substr(1, field.size() - 2);
+	if (field.find('"') == std::string_view::npos)
+		return true;
+
+	scratch.clear();
+	for (size_t i = 0; i < field.size(); i++) {
+		scratch.push_back(field[i]);
+		if (field[i] == '"' && i + 1 < field.size() && field[i + 1] == '"')
+			i++;
+	}
+	field = scratch;
+	return true;
+}
+
+/**
+ * Counts the rows in a block of memory which begins at the start of a row (a last row without a trailing newline is
+ * also counted)
+ *
+ * @param begin The first byte of the block
+ * @param end One past the last byte of the block
+ * @returns The amount of rows in the block
+ */
+size_t DataMiner::CsvScanner::countRows(const char* begin, const char* end) {
+	if (begin >= end)
+		return 0;
+
+	size_t rows = 0;
+	bool inQuotes = false;
+	uint64_t lastNewlines = 0;
+	const char* block = begin;
+	for (; block < end; block += blockSize) {
+		BlockMasks masks = classifyBlock(block, end);
+		uint64_t quoted = prefixXor(masks.quotes) ^ (inQuotes ? ~0ull : 0ull);
+		inQuotes = (quoted >> 63) != 0;
+		lastNewlines = masks.newlines & ~quoted;
+		rows += popCount(lastNewlines);
+	}
+
+	// Count a last row which has no newline at its end
+	size_t lastBit = (end - begin - 1) % blockSize;
+	if ((lastNewlines & (1ull << lastBit)) == 0)
+		rows++;
+	return rows;
+}
+
+/**
+ * Finds where every row ends in a block of memory which begins at the start of a row (a last row without a trailing
+ * newline ends at `end`)
+ *
+ * @param begin The first byte of the block
+ * @param end One past the last byte of the block
+ * @param rowEnds Receives the first byte after every row, in order
+ */
+void DataMiner::CsvScanner::findRowEnds(const char* begin, const char* end, std::vector<const char*>& rowEnds) {
+	const char* rowEnd = begin;
+	bool inQuotes = false;
+	for (const char* block = begin; block < end; block += blockSize) {
+		BlockMasks masks = classifyBlock(block, end);
+		uint64_t quoted = prefixXor(masks.quotes) ^ (inQuotes ? ~0ull : 0ull);
+		inQuotes = (quoted >> 63) != 0;
+		for (uint64_t newlines = masks.newlines & ~quoted; newlines != 0; newlines &= newlines - 1) {
+			rowEnd = block + trailingZeros(newlines) + 1;
+			rowEnds.push_back(rowEnd);
+		}
+	}
+
+	// A last row which has no newline at its end
+	if (rowEnd < end)
+		rowEnds.push_back(end);
+}
+
+/**
+ * Counts the quote characters in a block of memory
+ *
+ * @param begin The first byte of the block
+ * @param end One past the last byte of the block
+ * @returns The amount of quote characters in the block
+ */
+size_t DataMiner::CsvScanner::countQuotes(const char* begin, const char* end) {
+	size_t quotes = 0;
+	for (const char* block = begin; block < end; block += blockSize)
+		quotes += popCount(classifyBlock(block, end).quotes);
+	return quotes;
+}
+
+/**
+ * Finds the start of the first row after a position
+ *
+ * @param begin The position to search from
+ * @param end One past the last byte of the block
+ * @param inQuotes Whether `begin` lies inside of a quoted field
+ * @returns The first byte after the next newline outside of quotes, or `end` if there is none
+ */
+const char* DataMiner::CsvScanner::nextRowStart(const char* begin, const char* end, bool inQuotes) {
+	for (const char* block = begin; block < end; block += blockSize) {
+		BlockMasks masks = classifyBlock(block, end);
+		uint64_t quoted = prefixXor(masks.quotes) ^ (inQuotes ? ~0ull : 0ull);
+		inQuotes = (quoted >> 63) != 0;
+		uint64_t newlines = masks.newlines & ~quoted;
+		if (newlines != 0)
+			return block + trailingZeros(newlines) + 1;
+	}
+	return end;
+}
+
+/**
+ * Finds the end of the last complete row in a block of memory which begins at the start of a row
+ *
+ * @param begin The first byte of the block
+ * @param end One past the last byte of the block
+ * @returns The first byte after the last newline outside of quotes, or `begin` if there is none
+ */
+const char* DataMiner::CsvScanner::lastRowEnd(const char* begin, const char* end) {
+	const char* rowEnd = begin;
+	bool inQuotes = false;
+	for (const char* block = begin; block < end; block += blockSize) {
+		BlockMasks masks = classifyBlock(block, end);
+		uint64_t quoted = prefixXor(masks.quotes) ^ (inQuotes ? ~0ull : 0ull);
+		inQuotes = (quoted >> 63) != 0;
+		uint64_t newlines = masks.newlines & ~quoted;
+		if (newlines != 0)
+			rowEnd = block + (63 - leadingZeros(newlines)) + 1;
+	}
+	return rowEnd;
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Main data mining namespace
+ */
+namespace DataMiner {
+
+	/**
+	 * Splits a block of RFC 4180 csv data into fields
+	 *
+	 * The scanner classifies 64 bytes at a time (AVX2 or SSE2 when available, plain C++ otherwise) into bitmasks of
+	 * commas, newlines and quotes. Quoted regions are found with a prefix xor over the quote mask, so commas and
+	 * newlines inside of quoted fields are never treated as delimiters.
+	 */
+	class CsvScanner {
+	private:
+
+		/**
+		 * The start of the next field
+		 */
+		const char* cursor;
+
+		/**
+		 * One past the last byte of the block being scanned
+		 */
+		const char* end;
+
+		/**
+		 * The first byte of the 64 byte block currently being scanned
+		 */
+		const char* blockBase;
+
+		/**
+		 * Delimiters (commas and newlines outside of quotes) in the current block which have not been consumed yet
+		 */
+		uint64_t pending;
+
+		/**
+		 * Whether the byte after the current block starts inside of a quoted field
+		 */
+		bool inQuotes;
+
+		/**
+		 * Whether the last field returned was followed by a comma (so at least one more field follows)
+		 */
+		bool rowOpen;
+
+		/**
+		 * Storage for fields containing escaped quotes once they have been unescaped
+		 */
+		std::string scratch;
+
+		/**
+		 * Classifies the next 64 byte block and stores its delimiters into `pending`
+		 */
+		void loadBlock();
+
+	public:
+
+		/**
+		 * Creates a scanner over a block of memory, which must begin at the start of a row
+		 *
+		 * @param begin The first byte of the block
+		 * @param end One past the last byte of the block
+		 */
+		CsvScanner(const char* begin, const char* end);
+
+		/**
+		 * Reads the next field
+		 *
+		 * Quotes around the field are removed and escaped quotes are unescaped, the returned view is only valid until
+		 * the next call
+		 *
+		 * @param field The field that was read
+		 * @param lastInRow Set to whether the field was the last one in its row
+		 * @returns Whether or not there was a field left to read
+		 */
+		bool nextField(std::string_view& field, bool& lastInRow);
+
+		/**
+		 * Returns the position of the next unread byte
+		 *
+		 * @returns The position of the next unread byte
+		 */
+		const char* position() const {
+			return cursor;
+		}
+
+		/**
+		 * Counts the rows in a block of memory which begins at the start of a row (a last row without a trailing
+		 * newline is also counted)
+		 *
+		 * @param begin The first byte of the block
+		 * @param end One past the last byte of the block
+		 * @returns The amount of rows in the block
+		 */
+		static size_t countRows(const char* begin, const char* end);
+
+		/**
+		 * Finds where every row ends in a block of memory which begins at the start of a row (a last row without a
+		 * trailing newline ends at `end`)
+		 *
+		 * @param begin The first byte of the block
+		 * @param end One past the last byte of the block
+		 * @param rowEnds Receives the first byte after every row, in order
+		 */
+		static void findRowEnds(const char* begin, const char* end, std::vector<const char*>& rowEnds);
+
+		/**
+		 * Counts the quote characters in a block of memory
+		 *
+		 * @param begin The first byte of the block
+		 * @param end One past the last byte of the block
+		 * @returns The amount of quote characters in the block
+		 */
+		static size_t countQuotes(const char* begin, const char* end);
+
+		/**
+		 * Finds the start of the first row after a position
+		 *
+		 * @param begin The position to search from
+		 * @param end One past the last byte of the block
+		 * @param inQuotes Whether `begin` lies inside of a quoted field
+		 * @returns The first byte after the next newline outside of quotes, or `end` if there is none
+		 */
+		static const char* nextRowStart(const char* begin, const char* end, bool inQuotes);
+
+		/**
+		 * Finds the end of the last complete row in a block of memory which begins at the start of a row
+		 *
+		 * @param begin The first byte of the block
+		 * @param end One past the last byte of the block
+		 * @returns The first byte after the last newline outside of quotes, or `begin` if there is none
+		 */
+		static const char* lastRowEnd(const char* begin, const char* end);
+	};
+}
\ No newline at end of file
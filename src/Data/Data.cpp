@@ -19,20 +19,362 @@
 using namespace DataMiner;
 
 #include <Logger/Logger.hpp>
+#include <Data/ColumnAllocator.hpp>
+#include <Data/CompressedFile.hpp>
+#include <Data/CsvScanner.hpp>
+#include <Data/MappedFile.hpp>
+#include <Data/Number.hpp>
+#include <Data/RowSampler.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <sstream>
+#include <string_view>
+#include <thread>
+
+/**
+ * Smallest byte range worth handing to a separate worker thread
+ */
+static const size_t minChunkSize = 1 << 20;
+
+/**
+ * Amount of malformed numeric cells which are reported individually after loading
+ */
+static const size_t maxReportedCells = 10;
+
+/**
+ * Amount of rows read up front to estimate how many distinct values each string column has
+ */
+static const size_t cardinalitySampleRows = 1000;
+
+/**
+ * Amount of bytes read at once from inputs which cannot be mapped into memory (such as pipes)
+ */
+static const size_t streamBlockSize = 1 << 24;
+
+/**
+ * Fewest sampled rows needed before a string column may be stored in an arena instead of a dictionary
+ */
+static const size_t minArenaSampleRows = 100;
+
+/**
+ * A numeric cell which could not be read as a number while loading
+ */
+struct MalformedCell {
+	/**
+	 * The row of the cell
+	 */
+	size_t row;
+
+	/**
+	 * The column of the cell
+	 */
+	size_t column;
+
+	/**
+	 * The text of the cell
+	 */
+	std::string text;
+};
+
+/**
+ * Statistics of a single column over the rows of one chunk
+ */
+struct ColumnTally {
+	/**
+	 * The smallest value (infinity if there were no values)
+	 */
+	double min = std::numeric_limits<double>::infinity();
+
+	/**
+	 * The largest value (negative infinity if there were no values)
+	 */
+	double max = -std::numeric_limits<double>::infinity();
+
+	/**
+	 * The amount of missing values
+	 */
+	size_t nulls = 0;
+};
+
+/**
+ * What happened while loading rows, which is reported once loading is done
+ */
+struct DataMiner::CsvLoadReport {
+	/**
+	 * The amount of rows parsed by the load
+	 */
+	size_t rows = 0;
+
+	/**
+	 * The most threads used to parse a block of rows
+	 */
+	size_t threads = 0;
+
+	/**
+	 * The amount of numeric cells which were not valid numbers
+	 */
+	size_t malformedCount = 0;
+
+	/**
+	 * The first few malformed numeric cells
+	 */
+	std::vector<MalformedCell> malformed;
+};
+
+/**
+ * A newline aligned byte range of a csv body which is processed by a single worker thread
+ */
+struct DataMiner::CsvChunk {
+	/**
+	 * The first byte of the chunk (always the start of a line)
+	 */
+	const char* begin;
+
+	/**
+	 * One past the last byte of the chunk (always the start of a line or the end of the file)
+	 */
+	const char* end;
+
+	/**
+	 * The index of the first row of the chunk within the dataset
+	 */
+	size_t firstRow;
+
+	/**
+	 * The amount of rows in the chunk
+	 */
+	size_t rows;
+
+	/**
+	 * The amount of quote characters in the chunk
+	 */
+	size_t quotes;
+
+	/**
+	 * The error thrown while processing the chunk, null if there was none
+	 */
+	const char* error;
+
+	/**
+	 * The amount of numeric cells in the chunk which were not valid numbers
+	 */
+	size_t malformedCount;
+
+	/**
+	 * The first few malformed numeric cells in the chunk
+	 */
+	std::vector<MalformedCell> malformed;
+
+	/**
+	 * The dictionaries of the dictionary encoded string columns built from this chunk alone
+	 */
+	std::vector<StringDictionary> dictionaries;
+
+	/**
+	 * The strings of the arena encoded string columns in this chunk alone
+	 */
+	std::vector<StringArena> arenas;
+
+	/**
+	 * Maps the codes of each of the chunk's dictionaries to the codes of the dataset's dictionaries
+	 */
+	std::vector<std::vector<uint32_t>> remap;
+
+	/**
+	 * The statistics of every column over this chunk alone
+	 */
+	std::vector<ColumnTally> tallies;
+
+	/**
+	 * The distinct value sketches of the stored numeric columns over this chunk alone
+	 */
+	std::vector<HyperLogLog> numSketches;
+
+	/**
+	 * The distinct value sketches of the arena encoded string columns over this chunk alone
+	 */
+	std::vector<HyperLogLog> arenaSketches;
+
+	/**
+	 * The staging block the chunk's numbers are parsed into when the dataset's numeric columns are narrowed (starting
+	 * at the chunk's first row, with `stagedRows` doubles per column), null to parse them straight into the columns
+	 */
+	double* staged;
+
+	/**
+	 * The amount of rows each column of the staging block holds
+	 */
+	size_t stagedRows;
+
+	/**
+	 * Creates an unprocessed chunk
+	 * 
+	 * @param begin The first byte of the chunk
+	 * @param end One past the last byte of the chunk
+	 */
+	CsvChunk(const char* begin, const char* end) : begin(begin), end(end), firstRow(0), rows(0), quotes(0), error(nullptr), malformedCount(0), staged(nullptr), stagedRows(0) {}
+};
+
+/**
+ * Helper function to run a function on every chunk, each on its own thread
+ * 
+ * @throws The first error thrown by any of the chunks
+ * @param chunks The chunks to process
+ * @param fn The function to run on each chunk
+ */
+template <typename Fn> static void forEachChunk(std::vector<CsvChunk>& chunks, const Fn& fn) {
+	auto run = [&fn](CsvChunk& chunk) {
+		try {
+			fn(chunk);
+		}
+		catch (const char* error) {
+			chunk.error = error;
+		}
+		catch (const std::exception&) {
+			chunk.error = "Unexpected error while processing the dataset";
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(chunks.size());
+	for (size_t i = 1; i < chunks.size(); i++)
+		workers.emplace_back(run, std::ref(chunks[i]));
+	if (!chunks.empty())
+		run(chunks[0]);
+	for (std::thread& worker : workers)
+		worker.join();
+
+	for (const CsvChunk& chunk : chunks)
+		if (chunk.error != nullptr)
+			throw chunk.error;
+}
+
+/**
+ * Helper function to run a function over a list of columns in parallel, each worker takes the next column until there
+ * are none left
+ * 
+ * @throws A string with the first error any of the columns failed with
+ * @param columns The columns
+ * @param fn The function to run on each column
+ */
+template <typename Fn> static void forEachColumn(const std::vector<const DataColumn*>& columns, const Fn& fn) {
+	std::vector<const char*> errors(columns.size(), nullptr);
+	std::atomic<size_t> next(0);
+	auto run = [&columns, &fn, &errors, &next]() {
+		for (size_t i = next++; i < columns.size(); i = next++) {
+			try {
+				fn(*columns[i]);
+			}
+			catch (const char* error) {
+				errors[i] = error;
+			}
+			catch (const std::exception&) {
+				errors[i] = "Unexpected error while processing the dataset";
+			}
+		}
+	};
+
+	size_t threads = std::min<size_t>(std::max<size_t>(std::thread::hardware_concurrency(), 1), columns.size());
+	std::vector<std::thread> workers;
+	for (size_t i = 1; i < threads; i++)
+		workers.emplace_back(run);
+	run();
+	for (std::thread& worker : workers)
+		worker.join();
+
+	for (const char* error : errors)
+		if (error != nullptr)
+			throw error;
+}
+
+/**
+ * Helper function to split a block of csv rows into row aligned chunks, one per available core
+ * 
+ * Quotes are counted per chunk in parallel first so that each split point knows whether it lies inside of a quoted
+ * field, and is then moved forward to the start of the next row
+ * 
+ * @param begin The first byte of the block (must be the start of a row)
+ * @param end One past the last byte of the block
+ * @returns The chunks, covering the block exactly
+ */
+static std::vector<CsvChunk> splitChunks(const char* begin, const char* end) {
+	size_t size = end - begin;
+	size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	size_t count = std::max<size_t>(std::min(threads, size / minChunkSize), 1);
+
+	std::vector<CsvChunk> nominal;
+	nominal.reserve(count);
+	for (size_t i = 0; i < count; i++)
+		nominal.push_back({begin + size / count * i, i + 1 < count ? begin + size / count * (i + 1) : end});
+	if (count > 1) {
+		forEachChunk(nominal, [](CsvChunk& chunk) {
+			chunk.quotes = CsvScanner::countQuotes(chunk.begin, chunk.end);
+		});
+	}
+
+	std::vector<CsvChunk> chunks;
+	chunks.reserve(count);
+	const char* chunkBegin = begin;
+	size_t quotes = 0;
+	for (size_t i = 0; i < count && chunkBegin < end; i++) {
+		quotes += nominal[i].quotes;
+		const char* chunkEnd = end;
+		if (i + 1 < count && nominal[i].end > chunkBegin)
+			chunkEnd = CsvScanner::nextRowStart(nominal[i].end, end, quotes % 2 == 1);
+		else if (i + 1 < count)
+			continue;
+		chunks.push_back({chunkBegin, chunkEnd});
+		chunkBegin = chunkEnd;
+	}
+	return chunks;
+}
+
+/**
+ * Helper function to check whether a file is a regular file, rather than something like a pipe which can only be
+ * read once
+ * 
+ * @param filename The name of the file
+ * @returns Whether or not the file is a regular file (or does not exist)
+ */
+static bool isRegularFile(const char* filename) {
+	std::error_code error;
+	std::filesystem::file_status status = std::filesystem::status(filename, error);
+	return error || status.type() == std::filesystem::file_type::regular || status.type() == std::filesystem::file_type::not_found;
+}
+
+/**
+ * Checks whether a file holds csv data, either plain (`.csv`), compressed (`.csv.gz`, `.csv.zst`) or through a pipe
+ * (which is assumed to carry csv data)
+ * 
+ * @param filename The name of the file
+ * @returns Whether or not the file holds csv data
+ */
+bool DataMiner::Data::isCsvFile(const std::string& filename) {
+	std::string name = filename;
+	if (CompressedFile::isCompressed(name))
+		name = name.substr(0, name.find_last_of("."));
+	return name.substr(name.find_last_of(".") + 1) == "csv" || !isRegularFile(filename.c_str());
+}
 
 /**
  * Creates a new dataset
  * 
  * @throws A string explaining why the process failed
  */
-DataMiner::Data::Data() {
+DataMiner::Data::Data() : strCodes(nullptr), numData(nullptr), nrows(0), rowCapacity(0), ncols(0), hasHeader(false), sourceBytes(std::numeric_limits<size_t>::max()), sampled(false), cache(nullptr),
+	allocator(columnAllocator), numDataBytes(0), strCodesBytes(0) {
 	// Get file name and open it
 	std::string filename = logger->getInput<std::string>("Please input the file name of the dataset (csv)", [](const std::string& value, void* selfPtr) {
 		Data* self = (Data*) selfPtr;
 
 		// Currently only CSVs are accepted
-		if (value.substr(value.find_last_of(".") + 1) == "csv")
+		if (isCsvFile(value))
 			return self->openFile(value.c_str());
 		else
 			return false;
@@ -53,9 +395,9 @@ DataMiner::Data::Data() {
  * @throws A string explaining why the process failed
  * @param filename The file name
  */
-DataMiner::Data::Data(const char* filename) : file(filename) {
-	std::string filenameStr = filename;
-	if (filenameStr.substr(filenameStr.find_last_of(".") + 1) != "csv")
+DataMiner::Data::Data(const char* filename) : file(filename), strCodes(nullptr), numData(nullptr), nrows(0), rowCapacity(0), ncols(0), hasHeader(false), sourceBytes(std::numeric_limits<size_t>::max()), sampled(false), cache(nullptr),
+	allocator(columnAllocator), numDataBytes(0), strCodesBytes(0) {
+	if (!isCsvFile(filename))
 		throw "Invalid data file type (Only csv files are currently supported)";
 	if (!file.is_open())
 		throw "Unable to Open File Error";
@@ -68,53 +410,168 @@ DataMiner::Data::Data(const char* filename) : file(filename) {
 	}
 }
 
+/**
+ * Creates a dataset without any rows, reading its columns from the start of csv data
+ * 
+ * @throws A string explaining why the process failed
+ * @param cursor The first byte of the csv data, advanced past the header row if there is one
+ * @param end One past the last byte of the csv data
+ */
+DataMiner::Data::Data(const char*& cursor, const char* end) : strCodes(nullptr), numData(nullptr), nrows(0), rowCapacity(0), ncols(0), hasHeader(false), sourceBytes(std::numeric_limits<size_t>::max()), sampled(false), cache(nullptr),
+	allocator(columnAllocator), numDataBytes(0), strCodesBytes(0) {
+	readCsvSchema(cursor, end);
+}
+
 /**
  * Loads a csv file (assumes .csv file extension)
  * 
  * @throws A string explaining why the process failed
  */
 void DataMiner::Data::loadCsv(const char* filename) {
-	logger->info("This CSV reader does not support commas within fields nor does it support spaces in header names.");
+	source = filename;
+	sourceBytes = std::numeric_limits<size_t>::max();
+	sampled = false;
+
+	// Pipes can only be read once, front to back
+	if (!isRegularFile(filename)) {
+		std::ifstream input(filename, std::ios::binary);
+		if (!input.is_open())
+			throw "Unable to Open File Error";
+		loadCsvStream(input, false);
+		return;
+	}
 
-	// Get number of rows and columns in the data
-	nrows = std::count(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>(), '\n');
-	file.clear();
-	file.seekg(0, std::ios::beg);
+	// A cache written after an earlier parse of the same file skips parsing altogether
+	bool cached = false;
+	try {
+		cached = loadCache(filename);
+	}
+	catch (const char* error) {
+		logger->warn(error);
+		logger->warn("Ignoring the dataset cache and parsing the csv file instead");
+	}
+	if (cached) {
+		logger->info("Loaded the dataset from its binary cache");
+		promptRoles();
 
-	if (nrows < 1) throw "Error, no rows found in table";
+		// Columns which were excluded when the cache was saved are not in it
+		for (const DataColumn& col : cols) {
+			if (!col.stored && col.role != DataRole::excluded) {
+				logger->warn("The dataset cache does not contain a column which is no longer excluded, parsing the csv file instead");
+				freeBuffers();
+				cols.clear();
+				names.clear();
+				dictionaries.clear();
+				arenas.clear();
+				nrows = 0;
+				ncols = 0;
+				cached = false;
+				break;
+			}
+		}
+		if (cached) {
+			// The cache is only used when the file has not changed since it was saved, so all of it has been read
+			std::error_code error;
+			sourceBytes = static_cast<size_t>(std::filesystem::file_size(filename, error));
+			if (error)
+				sourceBytes = std::numeric_limits<size_t>::max();
+			return;
+		}
+	}
 
-	std::string firstLine;
-	std::getline(file, firstLine);
-	ncols = std::count(firstLine.begin(), firstLine.end(), ',')+1;
+	if (CompressedFile::isCompressed(filename)) {
+		// Compressed files are decompressed on another thread while the rows are parsed
+		CompressedFile source(filename);
+		std::istream input(&source);
+		try {
+			loadCsvStream(input, false);
+		}
+		catch (const char*) {
+			// A failed decompression explains any parse error better than the parse error itself
+			source.checkError();
+			throw;
+		}
+		source.checkError();
+	}
+	else {
+		// The whole file is mapped and parsed in place, fields are only ever copied into the dataset itself
+		MappedFile mapped(filename);
+		const char* cursor = mapped.begin();
+		const char* end = mapped.end();
+
+		readCsvSchema(cursor, end);
+		chooseStringEncodings(cursor, end);
+		std::unique_ptr<RowSampler> sampler = promptSample();
+		if (sampler) {
+			sampler->addRows(cursor, end);
+			loadCsvSample(*sampler);
+		}
+		else {
+			loadCsvRows(cursor, end);
+			sourceBytes = mapped.size();
+		}
+	}
+
+	// A cache of a sample would be mistaken for the whole file later on
+	if (sampled)
+		return;
+
+	bool saveCached = logger->getInput<std::string>("Would you like to save a binary cache of the parsed dataset to speed up future loads? (Y/N)", [](const std::string& value){
+		return value == "Y" || value == "N";
+	}) == "Y";
+	if (saveCached) {
+		try {
+			saveCache(filename);
+		}
+		catch (const char* error) {
+			logger->warn(error);
+		}
+	}
+}
+
+/**
+ * Reads the columns of a csv file from its first row(s), asking the user about the header and column roles
+ * 
+ * @throws A string explaining why the process failed
+ * @param cursor The first byte of the csv data, advanced past the header row if there is one
+ * @param end One past the last byte of the csv data
+ */
+void DataMiner::Data::readCsvSchema(const char*& cursor, const char* end) {
+	logger->info("This CSV reader does not support spaces in header names.");
+
+	// Get number of columns in the data
+	if (cursor == end) throw "Error, no rows found in table";
+
+	// Read the first row (its fields are copied as the scanner's views only live until the next field)
+	CsvScanner scanner(cursor, end);
+	std::vector<std::string> firstRow;
+	std::string_view value;
+	bool lastInRow = false;
+	while (!lastInRow && scanner.nextField(value, lastInRow))
+		firstRow.emplace_back(value);
+	ncols = firstRow.size();
 
 	if (ncols < 1) throw "Error, no columns found in table";
 
 	// Check if there is a header or not
-	bool hasHeader = logger->getInput<std::string>("Does your dataset have a header row? (Y/N)", [](const std::string& value){
+	hasHeader = logger->getInput<std::string>("Does your dataset have a header row? (Y/N)", [](const std::string& value){
 		return value == "Y" || value == "N";
 	}) == "Y";
 
-	if (!hasHeader) nrows += 1;
-
-	std::istringstream firstLineStream(firstLine);
 	if (hasHeader) {
 		// There is a header, go ahead and create columns using header names
-		std::string value;
-		while (std::getline(firstLineStream, value, ',')) {
-			cols.emplace_back(DataType::string, value.c_str(), DataRole::feature);
+		for (const std::string& name : firstRow) {
+			cols.emplace_back(DataType::string, name.c_str(), DataRole::feature);
 		}
-
-		// Get second line/row of data for type checking
-		std::string secondLine;
-		std::getline(file, secondLine);
-		std::istringstream secondLineStream(secondLine);
+		cursor = scanner.position();
 
 		// Go through second row for checking data types
 		size_t i = 0;
-		while (std::getline(secondLineStream, value, ',')) {
+		lastInRow = false;
+		while (!lastInRow && scanner.nextField(value, lastInRow)) {
 			if (i >= cols.size())
 				throw "Second row has a larger row count than header row";
-			if (value.find_first_not_of(".-1234567890") == std::string::npos)
+			if (value.empty() || isNumber(value))
 				cols[i].type = DataType::number;
 			else
 				cols[i].type = DataType::string;
@@ -122,17 +579,51 @@ void DataMiner::Data::loadCsv(const char* filename) {
 		}
 	}
 	else {
-		// There is no header, create columns without header names
-		std::string value;
-		while (std::getline(firstLineStream, value, ',')) {
+		// There is no header, create columns without header names and parse the first row again as data
+		for (const std::string& firstValue : firstRow) {
 			DataType dataType = DataType::string;
-			if (value.find_first_not_of(".-1234567890") == std::string::npos)
+			if (firstValue.empty() || isNumber(firstValue))
 				dataType = DataType::number;
 			
 			cols.emplace_back(dataType, "", DataRole::feature);
 		}
 	}
 
+	indexColumns();
+	promptRoles();
+}
+
+/**
+ * Skips the header row of csv data being appended to the dataset, checking it names the dataset's columns
+ * 
+ * @throws A string explaining why the process failed
+ * @param cursor The first byte of the csv data, advanced past the header row if the dataset has one
+ * @param end One past the last byte of the csv data
+ */
+void DataMiner::Data::skipCsvHeader(const char*& cursor, const char* end) const {
+	if (!hasHeader || cursor == end)
+		return;
+
+	CsvScanner scanner(cursor, end);
+	std::string_view value;
+	bool lastInRow = false;
+	size_t i = 0;
+	while (!lastInRow && scanner.nextField(value, lastInRow)) {
+		if (i >= ncols || cols[i].name != value)
+			throw "The header row of the appended file does not match the columns of the dataset";
+		i++;
+	}
+	if (i != ncols)
+		throw "The header row of the appended file does not match the columns of the dataset";
+	cursor = scanner.position();
+}
+
+/**
+ * Asks the user which roles the columns should have, then lists the columns
+ * 
+ * @throws A string explaining why the process failed
+ */
+void DataMiner::Data::promptRoles() {
 	// Prompt to change data roles
 	bool changeRoles = logger->getInput<std::string>("Would you like to change the data roles of any of your columns? IE: Drop columns/add a target. (Y/N)", [](const std::string& value){
 		return value == "Y" || value == "N";
@@ -211,51 +702,805 @@ void DataMiner::Data::loadCsv(const char* filename) {
 
 		logger->info(str.str().c_str());
 	}
+}
+
+/**
+ * Loads the rows of a block of csv data into the dataset, replacing any rows loaded before
+ * 
+ * @throws A string explaining why the process failed
+ * @param cursor The first byte of the rows (must be the start of a row)
+ * @param end One past the last byte of the rows
+ */
+void DataMiner::Data::loadCsvRows(const char* cursor, const char* end) {
+	clearRows();
+	CsvLoadReport report;
+	appendCsvRows(cursor, end, report);
+	narrowNumericColumns();
+	reportCsvLoad(report);
+}
+
+/**
+ * Loads csv data from a stream which can only be read once (such as a pipe), growing the column buffers as rows
+ * arrive
+ * 
+ * @throws A string explaining why the process failed
+ * @param input The stream to read from
+ */
+void DataMiner::Data::loadCsvStream(std::istream& input, bool append) {
+	std::vector<char> buffer;
+	size_t begin = 0;
+	size_t filled = 0;
+	bool done = false;
+
+	// Moves the unparsed bytes to the front of the buffer and reads the next block after them
+	auto fill = [&input, &buffer, &begin, &filled, &done]() {
+		if (begin != 0)
+			std::memmove(buffer.data(), buffer.data() + begin, filled - begin);
+		filled -= begin;
+		begin = 0;
+		if (buffer.size() < filled + streamBlockSize)
+			buffer.resize(std::max(buffer.size() * 2, filled + streamBlockSize));
+		input.read(buffer.data() + filled, buffer.size() - filled);
+		filled += static_cast<size_t>(input.gcount());
+		done = !input;
+	};
+
+	// The schema and string encodings are decided from the first rows, so read until there are enough of them (appends
+	// only need the header row)
+	size_t neededRows = append ? 1 : cardinalitySampleRows + 1;
+	fill();
+	while (!done && CsvScanner::countRows(buffer.data(), buffer.data() + filled) <= neededRows)
+		fill();
+
+	const char* cursor = buffer.data();
+	std::unique_ptr<RowSampler> sampler;
+	if (append)
+		skipCsvHeader(cursor, buffer.data() + filled);
+	else {
+		readCsvSchema(cursor, buffer.data() + filled);
+		chooseStringEncodings(cursor, buffer.data() + filled);
+		sampler = promptSample();
+		clearRows();
+	}
+	begin = cursor - buffer.data();
+
+	CsvLoadReport report;
+	while (true) {
+		const char* blockBegin = buffer.data() + begin;
+		const char* blockEnd = buffer.data() + filled;
+		const char* rowsEnd = done ? blockEnd : CsvScanner::lastRowEnd(blockBegin, blockEnd);
+		if (sampler)
+			sampler->addRows(blockBegin, rowsEnd);
+		else
+			appendCsvRows(blockBegin, rowsEnd, report);
+		begin = rowsEnd - buffer.data();
+		if (done)
+			break;
+		fill();
+	}
+	if (input.bad())
+		throw "Unable to read the dataset";
+
+	if (sampler) {
+		loadCsvSample(*sampler);
+		return;
+	}
+	if (!append)
+		narrowNumericColumns();
+	reportCsvLoad(report);
+}
+
+/**
+ * Adds the rows of another csv file (or pipe, or compressed file) to the dataset, the file must have the same columns
+ * as the dataset (and a matching header row if the dataset's file had one)
+ * 
+ * Statistics, sorted row indexes and quantile bins are updated with the new rows instead of being rebuilt
+ * 
+ * Numeric columns keep their narrowed storage types, only a column whose new values do not fit its type is widened
+ * 
+ * @throws A string explaining why the process failed
+ * @param filename The name of the csv file
+ * @returns The amount of rows added
+ */
+size_t DataMiner::Data::appendCsv(const char* filename) {
+	if (ncols == 0)
+		throw "The dataset has no columns to append rows to";
+	if (!isCsvFile(filename))
+		throw "Invalid data file type (Only csv files are currently supported)";
+
+	size_t firstRow = nrows;
+	if (!isRegularFile(filename)) {
+		std::ifstream input(filename, std::ios::binary);
+		if (!input.is_open())
+			throw "Unable to Open File Error";
+		loadCsvStream(input, true);
+	}
+	else if (CompressedFile::isCompressed(filename)) {
+		CompressedFile compressed(filename);
+		std::istream input(&compressed);
+		try {
+			loadCsvStream(input, true);
+		}
+		catch (const char*) {
+			compressed.checkError();
+			throw;
+		}
+		compressed.checkError();
+	}
+	else {
+		MappedFile mapped(filename);
+		const char* cursor = mapped.begin();
+		skipCsvHeader(cursor, mapped.end());
+		CsvLoadReport report;
+		appendCsvRows(cursor, mapped.end(), report);
+		reportCsvLoad(report);
+	}
+
+	extendIndexes(firstRow);
+	return nrows - firstRow;
+}
+
+/**
+ * Adds the rows written to the end of the dataset's own csv file since it was loaded (or last followed), so a growing
+ * file can be followed without loading it again
+ * 
+ * Only complete lines are read, a row still being written is picked up by a later call
+ * 
+ * @throws A string explaining why the process failed
+ * @returns The amount of rows added
+ */
+size_t DataMiner::Data::appendNewRows() {
+	if (sourceBytes == std::numeric_limits<size_t>::max())
+		throw "Only datasets fully loaded from an uncompressed csv file can read rows added to the file";
+
+	MappedFile mapped(source.c_str());
+	if (mapped.size() < sourceBytes)
+		throw "The csv file has shrunk since the dataset was loaded";
+	const char* cursor = mapped.begin() + sourceBytes;
+	const char* end = CsvScanner::lastRowEnd(cursor, mapped.end());
+	if (cursor == end)
+		return 0;
+
+	size_t firstRow = nrows;
+	CsvLoadReport report;
+	appendCsvRows(cursor, end, report);
+	reportCsvLoad(report);
+	sourceBytes = end - mapped.begin();
+
+	extendIndexes(firstRow);
+	return nrows - firstRow;
+}
+
+/**
+ * Asks the user whether to load only a random sample of the rows
+ * 
+ * @throws A string explaining why the process failed
+ * @returns The sampler to pass the rows through, null to load every row
+ */
+std::unique_ptr<RowSampler> DataMiner::Data::promptSample() const {
+	bool sample = logger->getInput<std::string>("Would you like to load only a random sample of the rows? (Y/N)", [](const std::string& value){
+		return value == "Y" || value == "N";
+	}) == "Y";
+	if (!sample)
+		return nullptr;
+
+	std::string size = logger->getInput<std::string>("How many rows should the sample keep?", [](const std::string& value){
+		return !value.empty() && value.size() < 19 && value.find_first_not_of("0123456789") == std::string::npos &&
+			value.find_first_not_of('0') != std::string::npos;
+	});
+
+	// Rare classes of a string target can be kept from disappearing out of the sample
+	size_t column = std::numeric_limits<size_t>::max();
+	for (size_t i = 0; i < cols.size(); i++) {
+		if (cols[i].role != DataRole::target || cols[i].type != DataType::string)
+			continue;
+		bool stratify = logger->getInput<std::string>("Should every class of the target keep an equal share of the sample? (Y/N)", [](const std::string& value){
+			return value == "Y" || value == "N";
+		}) == "Y";
+		if (stratify)
+			column = i;
+	}
+	return std::make_unique<RowSampler>(std::stoull(size), column);
+}
+
+/**
+ * Loads the rows kept by a sampler, replacing the rows of the dataset
+ * 
+ * @throws A string explaining why the process failed
+ * @param sampler The sampler every row of the file was offered to
+ */
+void DataMiner::Data::loadCsvSample(RowSampler& sampler) {
+	size_t offered = sampler.rowsSeen();
+	std::string sample = sampler.takeSample();
+	loadCsvRows(sample.data(), sample.data() + sample.size());
+	sampled = true;
+
+	std::stringstream str;
+	str << "Kept a random sample of " << nrows << " out of " << offered << " rows";
+	logger->info(str.str().c_str());
+}
+
+/**
+ * Removes all rows from the dataset, keeping its columns
+ */
+void DataMiner::Data::clearRows() {
+	freeBuffers();
+	dictionaries.clear();
+	arenas.clear();
+	numSketches.clear();
+	arenaSketches.clear();
+	sortedRows.clear();
+	bins.clear();
+	binEdges.clear();
+	nrows = 0;
+	rowCapacity = 0;
+	for (DataColumn& col : cols) {
+		col.storage = NumberStorage::float64;
+		col.min = std::numeric_limits<double>::quiet_NaN();
+		col.max = std::numeric_limits<double>::quiet_NaN();
+		col.nullCount = 0;
+		col.distinctCount = 0;
+	}
+}
+
+/**
+ * Makes sure the column buffers have room for an amount of rows, growing them geometrically
+ * 
+ * @throws A string explaining why the process failed
+ * @param rows The amount of rows the buffers need room for
+ */
+void DataMiner::Data::reserveRows(size_t rows) {
+	// Buffers borrowed from a cache are read only, so they are copied onto the heap before any rows are added
+	if (rows <= rowCapacity && (cache == nullptr || rows == nrows))
+		return;
+
+	// Every numeric column keeps its storage type, so narrowed columns grow at their own width
+	size_t capacity = rows <= rowCapacity ? rowCapacity : ColumnAllocator::paddedRows(std::max(rows, rowCapacity * 2));
+	std::vector<size_t> offsets;
+	size_t newNumDataBytes = 0;
+	size_t dictionaryColumns = 0;
+	for (const DataColumn& col : cols) {
+		if (col.stored && col.type == DataType::number) {
+			offsets.push_back(newNumDataBytes);
+			newNumDataBytes += capacity * numberStorageSize(col.storage);
+		}
+		if (col.stored && col.type == DataType::string && col.encoding == StringEncoding::dictionary)
+			dictionaryColumns++;
+	}
+
+	size_t newStrCodesBytes = dictionaryColumns * capacity * sizeof(uint32_t);
+	char* newNumData = static_cast<char*>(allocator->allocate(newNumDataBytes));
+	uint32_t* newStrCodes;
+	try {
+		newStrCodes = static_cast<uint32_t*>(allocator->allocate(newStrCodesBytes));
+	}
+	catch (const char*) {
+		allocator->deallocate(newNumData, newNumDataBytes);
+		throw;
+	}
+	for (const DataColumn& col : cols)
+		if (col.stored && col.type == DataType::number && nrows != 0)
+			std::memcpy(newNumData + offsets[col.index], numData + numOffsets[col.index], nrows * numberStorageSize(col.storage));
+	for (size_t column = 0; column < dictionaryColumns; column++)
+		std::copy(strCodes + column * rowCapacity, strCodes + column * rowCapacity + nrows, newStrCodes + column * capacity);
+
+	freeBuffers();
+	numData = newNumData;
+	strCodes = newStrCodes;
+	numOffsets = std::move(offsets);
+	numDataBytes = newNumDataBytes;
+	strCodesBytes = newStrCodesBytes;
+	rowCapacity = capacity;
+
+	std::stringstream str;
+	str << "Successfully allocated " << (static_cast<double>(newNumDataBytes + newStrCodesBytes) / 1024.0) << "KB of memory!";
+	logger->info(str.str().c_str());
+}
+
+/**
+ * Helper function to copy the values of a column into another storage type (the values must fit it exactly)
+ * 
+ * @param values The values of the column
+ * @param column The first value of the copy
+ * @param rows The amount of rows to copy
+ */
+template <typename T, typename S> static void convertColumn(const S* values, T* column, size_t rows) {
+	for (size_t row = 0; row < rows; row++) {
+		if (!isMissingNumber(values[row]))
+			column[row] = static_cast<T>(values[row]);
+		else if constexpr (std::is_floating_point_v<T>)
+			column[row] = std::numeric_limits<T>::quiet_NaN();
+		else
+			column[row] = std::numeric_limits<T>::min();
+	}
+}
+
+/**
+ * Helper function to copy the values of a column into a buffer of any storage type (the values must fit it exactly)
+ * 
+ * @param values The values of the column
+ * @param column The first value of the copy
+ * @param storage The storage type of the copy
+ * @param rows The amount of rows to copy
+ */
+template <typename S> static void storeColumn(const S* values, char* column, NumberStorage storage, size_t rows) {
+	switch (storage) {
+		case NumberStorage::float64: convertColumn(values, reinterpret_cast<double*>(column), rows); break;
+		case NumberStorage::float32: convertColumn(values, reinterpret_cast<float*>(column), rows); break;
+		case NumberStorage::int32: convertColumn(values, reinterpret_cast<int32_t*>(column), rows); break;
+		case NumberStorage::int16: convertColumn(values, reinterpret_cast<int16_t*>(column), rows); break;
+		case NumberStorage::int8: convertColumn(values, reinterpret_cast<int8_t*>(column), rows); break;
+	}
+}
+
+/**
+ * Helper function to find the narrowest storage type which holds a block of values exactly (integers keep the
+ * smallest value of their type free to mark missing values)
+ * 
+ * @param values The values (NaN for missing values)
+ * @param rows The amount of values
+ * @returns The storage type
+ */
+static NumberStorage narrowestStorage(const double* values, size_t rows) {
+	bool integral = true;
+	bool single = true;
+	double min = 0;
+	double max = 0;
+	for (size_t row = 0; row < rows && (integral || single); row++) {
+		double value = values[row];
+		if (std::isnan(value))
+			continue;
+		if (value != std::trunc(value) || std::fabs(value) > std::numeric_limits<int32_t>::max() || (value == 0 && std::signbit(value)))
+			integral = false;
+		if (static_cast<double>(static_cast<float>(value)) != value)
+			single = false;
+		min = std::min(min, value);
+		max = std::max(max, value);
+	}
+
+	double limit = std::max(-min, max);
+	if (integral && limit <= std::numeric_limits<int8_t>::max())
+		return NumberStorage::int8;
+	if (integral && limit <= std::numeric_limits<int16_t>::max())
+		return NumberStorage::int16;
+	if (integral)
+		return NumberStorage::int32;
+	if (single)
+		return NumberStorage::float32;
+	return NumberStorage::float64;
+}
+
+/**
+ * Helper function to find the narrowest storage type which holds every value of two storage types exactly
+ * 
+ * @param first The first storage type
+ * @param second The second storage type
+ * @returns The storage type
+ */
+static NumberStorage widerStorage(NumberStorage first, NumberStorage second) {
+	if (first == second)
+		return first;
+	bool firstInteger = first != NumberStorage::float64 && first != NumberStorage::float32;
+	bool secondInteger = second != NumberStorage::float64 && second != NumberStorage::float32;
+
+	// Integers are declared from widest to narrowest, and single floats hold every 16 bit integer but not every 32 bit one
+	if (firstInteger && secondInteger)
+		return std::min(first, second);
+	if (first == NumberStorage::float32 && second != NumberStorage::float64 && second != NumberStorage::int32)
+		return first;
+	if (second == NumberStorage::float32 && first != NumberStorage::float64 && first != NumberStorage::int32)
+		return second;
+	return NumberStorage::float64;
+}
+
+/**
+ * Stores every numeric column in the narrowest type which holds all of its values exactly, once a load has parsed all
+ * of its rows as doubles
+ * 
+ * @throws A string explaining why the process failed
+ */
+void DataMiner::Data::narrowNumericColumns() {
+	// Cached buffers were narrowed before they were saved
+	if (cache != nullptr)
+		return;
+
+	std::vector<const DataColumn*> numeric;
+	for (const DataColumn& col : cols)
+		if (col.stored && col.type == DataType::number)
+			numeric.push_back(&col);
+	if (numeric.empty())
+		return;
+
+	std::vector<NumberStorage> storages(numeric.size(), NumberStorage::float64);
+	forEachColumn(numeric, [this, &storages](const DataColumn& col) {
+		storages[col.index] = narrowestStorage(numbers<const double>(col), nrows);
+	});
+	if (std::all_of(storages.begin(), storages.end(), [](NumberStorage storage) { return storage == NumberStorage::float64; }))
+		return;
+
+	// Every column keeps the padded row count, so narrowed columns still start on a cache line
+	std::vector<size_t> offsets(numeric.size());
+	size_t bytes = 0;
+	for (size_t i = 0; i < storages.size(); i++) {
+		offsets[i] = bytes;
+		bytes += rowCapacity * numberStorageSize(storages[i]);
+	}
+	char* narrowed = static_cast<char*>(allocator->allocate(bytes));
+	forEachColumn(numeric, [this, &storages, &offsets, narrowed](const DataColumn& col) {
+		storeColumn(numbers<const double>(col), narrowed + offsets[col.index], storages[col.index], nrows);
+	});
+
+	allocator->deallocate(numData, numDataBytes);
+	numData = narrowed;
+	numDataBytes = bytes;
+	numOffsets = std::move(offsets);
+	for (DataColumn& col : cols)
+		if (col.stored && col.type == DataType::number)
+			col.storage = storages[col.index];
+
+	std::stringstream str;
+	str << "Narrowed the numeric columns to " << (static_cast<double>(bytes) / 1024.0) << "KB of memory";
+	logger->info(str.str().c_str());
+}
+
+/**
+ * Stores the numeric columns in wider types, copying the rows already in the dataset
+ * 
+ * @throws A string explaining why the process failed
+ * @param storages The storage type of each numeric column, which must hold every value of its current type exactly
+ */
+void DataMiner::Data::widenNumericColumns(const std::vector<NumberStorage>& storages) {
+	std::vector<const DataColumn*> numeric;
+	for (const DataColumn& col : cols)
+		if (col.stored && col.type == DataType::number)
+			numeric.push_back(&col);
+
+	std::vector<size_t> offsets(numeric.size());
+	size_t bytes = 0;
+	for (size_t i = 0; i < storages.size(); i++) {
+		offsets[i] = bytes;
+		bytes += rowCapacity * numberStorageSize(storages[i]);
+	}
+	char* widened = static_cast<char*>(allocator->allocate(bytes));
+	forEachColumn(numeric, [this, &storages, &offsets, widened](const DataColumn& col) {
+		char* column = widened + offsets[col.index];
+		if (storages[col.index] == col.storage)
+			std::memcpy(column, numData + numOffsets[col.index], nrows * numberStorageSize(col.storage));
+		else
+			visitNumbers(col, [this, &storages, &col, column](const auto* values) {
+				storeColumn(values, column, storages[col.index], nrows);
+			});
+	});
+
+	allocator->deallocate(numData, numDataBytes);
+	numData = widened;
+	numDataBytes = bytes;
+	numOffsets = std::move(offsets);
+	for (DataColumn& col : cols)
+		if (col.stored && col.type == DataType::number)
+			col.storage = storages[col.index];
+}
+
+/**
+ * Stores rows parsed into a staging block in the numeric columns, widening only the columns whose new values do not
+ * fit their storage type
+ * 
+ * @throws A string explaining why the process failed
+ * @param staged The staging block, with `rows` doubles per numeric column
+ * @param firstRow The row the staged rows are stored from (the rows before it are already in the columns)
+ * @param rows The amount of staged rows
+ */
+void DataMiner::Data::storeStagedRows(const double* staged, size_t firstRow, size_t rows) {
+	std::vector<const DataColumn*> numeric;
+	for (const DataColumn& col : cols)
+		if (col.stored && col.type == DataType::number)
+			numeric.push_back(&col);
+
+	// Only the new rows are checked, the rows already stored fit their column's type
+	std::vector<NumberStorage> storages(numeric.size());
+	forEachColumn(numeric, [staged, rows, &storages](const DataColumn& col) {
+		storages[col.index] = widerStorage(col.storage, narrowestStorage(staged + col.index * rows, rows));
+	});
+	for (const DataColumn* col : numeric) {
+		if (storages[col->index] != col->storage) {
+			widenNumericColumns(storages);
+			break;
+		}
+	}
+
+	forEachColumn(numeric, [this, staged, firstRow, rows](const DataColumn& col) {
+		size_t size = numberStorageSize(col.storage);
+		storeColumn(staged + col.index * rows, numData + numOffsets[col.index] + firstRow * size, col.storage, rows);
+	});
+}
+
+/**
+ * Parses the rows of a block of csv data and adds them after the rows already in the dataset
+ * 
+ * @throws A string explaining why the process failed
+ * @param cursor The first byte of the rows (must be the start of a row)
+ * @param end One past the last byte of the rows
+ * @param report Collects the thread count and malformed cells of the load
+ */
+void DataMiner::Data::appendCsvRows(const char* cursor, const char* end, CsvLoadReport& report) {
+	// Split the block into line aligned chunks and count the rows of every chunk in parallel
+	std::vector<CsvChunk> chunks = splitChunks(cursor, end);
+	forEachChunk(chunks, [](CsvChunk& chunk) {
+		chunk.rows = CsvScanner::countRows(chunk.begin, chunk.end);
+	});
+
+	size_t firstRow = nrows;
+	size_t rows = nrows;
+	for (CsvChunk& chunk : chunks) {
+		chunk.firstRow = rows;
+		rows += chunk.rows;
+	}
 
-	// Allocate sufficient data on the heap
-	size_t dataStrSize = 0;
-	size_t dataNumSize = 0;
-	for (DataColumn colType : cols) {
-		if (colType.type == DataType::number)
-			dataNumSize += nrows;
-		if (colType.type == DataType::string)
-			dataStrSize += nrows;
+	size_t numColumns = 0;
+	size_t dictionaryColumns = 0;
+	size_t arenaColumns = 0;
+	for (const DataColumn& col : cols) {
+		if (col.stored && col.type == DataType::number)
+			numColumns++;
+		if (col.stored && col.type == DataType::string && col.encoding == StringEncoding::dictionary)
+			dictionaryColumns++;
+		if (col.stored && col.type == DataType::string && col.encoding == StringEncoding::arena)
+			arenaColumns++;
+	}
+	reserveRows(rows);
+	dictionaries.resize(dictionaryColumns);
+	arenas.resize(arenaColumns);
+	numSketches.resize(numColumns);
+	arenaSketches.resize(arenaColumns);
+
+	// Narrowed columns can not hold the parsed doubles, so the new rows are parsed into a staging block and stored in
+	// the columns once it is known which of them need a wider type
+	bool narrowed = std::any_of(cols.begin(), cols.end(), [](const DataColumn& col) {
+		return col.stored && col.type == DataType::number && col.storage != NumberStorage::float64;
+	});
+	std::unique_ptr<double[]> staged;
+	if (narrowed) {
+		staged.reset(new double[numColumns * (rows - firstRow)]);
+		for (CsvChunk& chunk : chunks) {
+			chunk.staged = staged.get() + (chunk.firstRow - firstRow);
+			chunk.stagedRows = rows - firstRow;
+		}
 	}
-	strData = new std::string[dataStrSize];
-	numData = new double[dataNumSize];
 
+	// Every chunk knows its first row, so each worker can write straight into its own rows of the column buffers
+	forEachChunk(chunks, [this, numColumns, dictionaryColumns, arenaColumns](CsvChunk& chunk) {
+		chunk.dictionaries.resize(dictionaryColumns);
+		chunk.arenas.resize(arenaColumns);
+		chunk.tallies.resize(ncols);
+		chunk.numSketches.resize(numColumns);
+		chunk.arenaSketches.resize(arenaColumns);
+		for (StringArena& arena : chunk.arenas)
+			arena.reserve(chunk.rows, 0);
+		parseCsvChunk(chunk);
+	});
+	if (narrowed)
+		storeStagedRows(staged.get(), firstRow, rows - firstRow);
+	nrows = rows;
+
+	// The chunks' dictionaries and arenas are merged into the dataset's (with their codes rewritten in parallel), the
+	// first chunk's simply become the dataset's when there were no rows before
+	for (size_t i = 0; i < chunks.size(); i++) {
+		CsvChunk& chunk = chunks[i];
+		if (i == 0 && firstRow == 0) {
+			dictionaries = std::move(chunk.dictionaries);
+			arenas = std::move(chunk.arenas);
+			continue;
+		}
+
+		chunk.remap.resize(dictionaryColumns);
+		for (size_t column = 0; column < dictionaryColumns; column++) {
+			const StringDictionary& local = chunk.dictionaries[column];
+			chunk.remap[column].resize(local.size());
+			for (uint32_t code = 0; code < local.size(); code++)
+				chunk.remap[column][code] = dictionaries[column].insert(local.get(code));
+		}
+		chunk.dictionaries.clear();
+
+		for (size_t column = 0; column < arenaColumns; column++)
+			arenas[column].append(chunk.arenas[column]);
+		chunk.arenas.clear();
+	}
+	forEachChunk(chunks, [this](CsvChunk& chunk) {
+		for (size_t column = 0; column < chunk.remap.size(); column++) {
+			uint32_t* codes = strCodes + column * rowCapacity + chunk.firstRow;
+			const std::vector<uint32_t>& remap = chunk.remap[column];
+			for (size_t row = 0; row < chunk.rows; row++)
+				codes[row] = remap[codes[row]];
+		}
+	});
+
+	// Fold the chunks' column statistics into the dataset's
+	for (const CsvChunk& chunk : chunks) {
+		for (size_t column = 0; column < ncols; column++) {
+			DataColumn& col = cols[column];
+			const ColumnTally& tally = chunk.tallies[column];
+			col.nullCount += tally.nulls;
+			if (tally.min <= tally.max) {
+				col.min = std::isnan(col.min) ? tally.min : std::min(col.min, tally.min);
+				col.max = std::isnan(col.max) ? tally.max : std::max(col.max, tally.max);
+			}
+		}
+		for (size_t column = 0; column < numColumns; column++)
+			numSketches[column].merge(chunk.numSketches[column]);
+		for (size_t column = 0; column < arenaColumns; column++)
+			arenaSketches[column].merge(chunk.arenaSketches[column]);
+	}
+	for (DataColumn& col : cols) {
+		if (!col.stored)
+			continue;
+		if (col.type == DataType::number)
+			col.distinctCount = numSketches[col.index].estimate();
+		else if (col.encoding == StringEncoding::arena)
+			col.distinctCount = arenaSketches[col.index].estimate();
+		else
+			col.distinctCount = dictionaries[col.index].size() - (dictionaries[col.index].find("") != StringDictionary::npos);
+
+		// The estimate can overshoot slightly, but there are never more distinct values than values
+		col.distinctCount = std::min(col.distinctCount, nrows - col.nullCount);
+	}
+
+	report.rows += rows - firstRow;
+	report.threads = std::max(report.threads, chunks.size());
+	for (CsvChunk& chunk : chunks) {
+		report.malformedCount += chunk.malformedCount;
+		for (MalformedCell& cell : chunk.malformed)
+			if (report.malformed.size() < maxReportedCells)
+				report.malformed.push_back(std::move(cell));
+	}
+}
+
+/**
+ * Logs how many rows were loaded, and the cells which could not be read as numbers
+ * 
+ * @param report The report of the load
+ */
+void DataMiner::Data::reportCsvLoad(const CsvLoadReport& report) const {
 	std::stringstream str;
-	str << "Successfully allocated " << (static_cast<double>(dataStrSize*sizeof(std::string) + dataNumSize*sizeof(double)) / 1024.0)
-		<< "KB of memory!";
+	str << "Parsed " << report.rows << " rows using " << std::max<size_t>(report.threads, 1) << " thread(s)";
+	if (report.rows != nrows)
+		str << ", the dataset now has " << nrows << " rows";
 	logger->info(str.str().c_str());
 
-	file.clear();
-	file.seekg(0, std::ios::beg);
-
-	std::string line;
-	if (hasHeader) std::getline(file, line);
-
-	size_t rowIndex = 0;
-	while (std::getline(file, line)) {
-		std::string value;
-		std::istringstream lineStream(line);
-		size_t colIndex = 0;
-		size_t numIndex = 0;
-		size_t strIndex = 0;
-		while (std::getline(lineStream, value, ',')) {
-			if (colIndex >= ncols)
-				throw "There is a row with more columns than the header/first row";
-			if (cols[colIndex].type == DataType::number) {
-				numData[numIndex*nrows + rowIndex] = std::stod(value);
-				numIndex++;
+	// The cells which could not be read as numbers are kept as missing values
+	for (const MalformedCell& cell : report.malformed) {
+		str.str("");
+		str << "Invalid number `" << cell.text << "` in row " << (cell.row + 1) << ", column " << (cell.column + 1)
+			<< " (" << cols[cell.column].name << "), treating it as a missing value";
+		logger->warn(str.str().c_str());
+	}
+	if (report.malformedCount > report.malformed.size()) {
+		str.str("");
+		str << (report.malformedCount - report.malformed.size()) << " more invalid numbers were treated as missing values";
+		logger->warn(str.str().c_str());
+	}
+}
+
+/**
+ * Chooses how each string column is stored from the amount of distinct values in the first rows of the data
+ * 
+ * Columns where most sampled values are distinct (ids, free text) gain nothing from a dictionary and are stored in
+ * an arena instead
+ * 
+ * @throws A string explaining why the process failed
+ * @param begin The first byte of the csv data (must be the start of a row)
+ * @param end One past the last byte of the csv data
+ */
+void DataMiner::Data::chooseStringEncodings(const char* begin, const char* end) {
+	std::vector<StringDictionary> samples(ncols);
+	CsvScanner scanner(begin, end);
+	std::string_view value;
+	bool lastInRow;
+	size_t colIndex = 0;
+	size_t rows = 0;
+	while (rows < cardinalitySampleRows && scanner.nextField(value, lastInRow)) {
+		if (colIndex < ncols && cols[colIndex].type == DataType::string && cols[colIndex].role != DataRole::excluded)
+			samples[colIndex].insert(value);
+		colIndex++;
+
+		if (lastInRow) {
+			colIndex = 0;
+			rows++;
+		}
+	}
+
+	for (size_t i = 0; i < ncols; i++) {
+		if (cols[i].type != DataType::string)
+			continue;
+		
+		cols[i].encoding = StringEncoding::dictionary;
+		if (rows >= minArenaSampleRows && samples[i].size() * 2 > rows) {
+			cols[i].encoding = StringEncoding::arena;
+
+			std::stringstream str;
+			str << "Column " << (i + 1) << " (" << cols[i].name << ") has mostly distinct values, storing it as raw text";
+			logger->info(str.str().c_str());
+		}
+	}
+	indexColumns();
+}
+
+/**
+ * Parses the rows of a line aligned chunk of csv data into the dataset's buffers
+ * 
+ * @throws A string explaining why the process failed
+ * @param chunk The chunk to parse, which receives the chunk's own string dictionaries/arenas and malformed cells
+ */
+void DataMiner::Data::parseCsvChunk(CsvChunk& chunk) {
+	auto numberCell = [this, &chunk](const DataColumn& col, size_t row) -> double& {
+		if (chunk.staged != nullptr)
+			return chunk.staged[col.index * chunk.stagedRows + row - chunk.firstRow];
+		return numbers<double>(col)[row];
+	};
+
+	CsvScanner scanner(chunk.begin, chunk.end);
+	std::string_view value;
+	bool lastInRow;
+	size_t rowIndex = chunk.firstRow;
+	size_t colIndex = 0;
+	while (scanner.nextField(value, lastInRow)) {
+		if (colIndex >= ncols)
+			throw "There is a row with more columns than the header/first row";
+		const DataColumn& col = cols[colIndex];
+		if (!col.stored) {
+			// Excluded columns are only tokenized past
+		}
+		else if (col.type == DataType::number) {
+			ColumnTally& tally = chunk.tallies[colIndex];
+			double& cell = numberCell(col, rowIndex);
+			if (!parseNumber(value, cell)) {
+				// Empty cells are missing values, anything else is reported once loading is done
+				cell = std::numeric_limits<double>::quiet_NaN();
+				if (!value.empty()) {
+					if (chunk.malformed.size() < maxReportedCells)
+						chunk.malformed.push_back({rowIndex, colIndex, std::string(value)});
+					chunk.malformedCount++;
+				}
 			}
-			if (cols[colIndex].type == DataType::string) {
-				strData[strIndex*nrows + rowIndex] = value;
-				strIndex++;
+			if (std::isnan(cell))
+				tally.nulls++;
+			else {
+				tally.min = std::min(tally.min, cell);
+				tally.max = std::max(tally.max, cell);
+				chunk.numSketches[col.index].add(HyperLogLog::hash(cell));
 			}
-			colIndex++;
 		}
-		rowIndex++;
+		else if (col.encoding == StringEncoding::dictionary) {
+			strCodes[col.index*rowCapacity + rowIndex] = chunk.dictionaries[col.index].insert(value);
+			if (value.empty())
+				chunk.tallies[colIndex].nulls++;
+		}
+		else {
+			chunk.arenas[col.index].append(value);
+			if (value.empty())
+				chunk.tallies[colIndex].nulls++;
+			else
+				chunk.arenaSketches[col.index].add(HyperLogLog::hash(value));
+		}
+		colIndex++;
+
+		if (lastInRow) {
+			// Values missing from the end of the row (or the whole row for empty lines) are empty
+			for (; colIndex < ncols; colIndex++) {
+				const DataColumn& missing = cols[colIndex];
+				if (!missing.stored)
+					continue;
+				chunk.tallies[colIndex].nulls++;
+				if (missing.type == DataType::number)
+					numberCell(missing, rowIndex) = std::numeric_limits<double>::quiet_NaN();
+				else if (missing.encoding == StringEncoding::dictionary)
+					strCodes[missing.index*rowCapacity + rowIndex] = chunk.dictionaries[missing.index].insert("");
+				else
+					chunk.arenas[missing.index].append("");
+			}
+
+			colIndex = 0;
+			rowIndex++;
+		}
 	}
 }
 
@@ -264,48 +1509,116 @@ void DataMiner::Data::loadCsv(const char* filename) {
  */
 DataMiner::Data::~Data() {
 	logger->info("Deleted allocated data");
-	delete[] strData;
-	delete[] numData;
+	freeBuffers();
 }
 
 /**
- * Gets the index of the column within the specific datatype (useful for retrieving data)
+ * Frees the column buffers (or unmaps the cache they point into)
+ */
+void DataMiner::Data::freeBuffers() {
+	if (cache != nullptr) {
+		delete cache;
+		cache = nullptr;
+	}
+	else {
+		allocator->deallocate(strCodes, strCodesBytes);
+		allocator->deallocate(numData, numDataBytes);
+	}
+	strCodes = nullptr;
+	numData = nullptr;
+	numOffsets.clear();
+	numDataBytes = 0;
+	strCodesBytes = 0;
+}
+
+/**
+ * Gets the index of the column within the specific datatype and string encoding (useful for retrieving data)
  * 
  * @throws A string with a description of why the process failed
  * @param column The column whose index to retrieve
- * @returns The index of the column within the datatype
+ * @returns The index of the column within the datatype and string encoding
  */
 size_t DataMiner::Data::getIndex(const char* column) const {
 	return getIndex(getColumn(column));
 }
 
 /**
- * Gets the index of the column within the specific datatype (useful for retrieving data)
+ * Gets the index of the column within the specific datatype and string encoding (useful for retrieving data)
  * 
  * @throws A string with a description of why the process failed
  * @param column The column whose index to retrieve
- * @returns The index of the column within the datatype
+ * @returns The index of the column within the datatype and string encoding
  */
 size_t DataMiner::Data::getIndex(size_t column) const {
 	return getIndex(getColumn(column));
 }
 
 /**
- * Gets the index of the column within the specific datatype (useful for retrieving data)
+ * Gets the index of the column within the specific datatype and string encoding (useful for retrieving data)
  * 
  * @throws A string with a description of why the process failed
  * @param column The column whose index to retrieve
- * @returns The index of the column within the datatype
+ * @returns The index of the column within the datatype and string encoding
  */
 size_t DataMiner::Data::getIndex(const DataColumn& column) const {
-	size_t index = 0;
-	for (const DataColumn& col : cols) {
-		if (&col == &column)
-			return index;
-		if (col.type == column.type)
-			index++;
+	findColumn(column);
+	if (!column.stored)
+		throw "Column was excluded when the dataset was loaded";
+	return column.index;
+}
+
+/**
+ * Works out which columns are stored and the storage index of every stored column, and rebuilds the column name
+ * lookup, must be called whenever columns are added or their types, roles or string encodings change
+ */
+void DataMiner::Data::indexColumns() {
+	size_t numColumns = 0;
+	size_t dictionaryColumns = 0;
+	size_t arenaColumns = 0;
+	names.clear();
+	for (size_t i = 0; i < cols.size(); i++) {
+		DataColumn& col = cols[i];
+		col.stored = col.role != DataRole::excluded;
+		if (!col.stored)
+			col.index = 0;
+		else if (col.type == DataType::number)
+			col.index = numColumns++;
+		else if (col.encoding == StringEncoding::dictionary)
+			col.index = dictionaryColumns++;
+		else
+			col.index = arenaColumns++;
+
+		// The first of several columns with the same name wins
+		names.emplace(col.name, i);
 	}
-	throw "Column not found in dataset";
+}
+
+/**
+ * Finds the position of a column within the dataset
+ * 
+ * @throws A string with a description of why the process failed
+ * @param column The column name
+ * @returns The position of the column
+ */
+size_t DataMiner::Data::findColumn(const char* column) const {
+	auto position = names.find(column);
+	if (position == names.end())
+		throw "Column not found error";
+	return position->second;
+}
+
+/**
+ * Finds the position of a column within the dataset
+ * 
+ * @throws A string with a description of why the process failed
+ * @param column The column, which must belong to this dataset
+ * @returns The position of the column
+ */
+size_t DataMiner::Data::findColumn(const DataColumn& column) const {
+	std::less<const DataColumn*> before;
+	if (cols.empty() || before(&column, cols.data()) || !before(&column, cols.data() + cols.size()))
+		throw "Column not found in dataset";
+	return &column - cols.data();
 }
 
 /**
@@ -328,10 +1641,7 @@ bool DataMiner::Data::openFile(const char* filename) {
  * @returns The column
  */
 const DataColumn& DataMiner::Data::getColumn(const char* column) const {
-	for (const DataColumn& col : cols)
-		if (col.name == column)
-			return col;
-	throw "Column not found error";
+	return cols[findColumn(column)];
 }
 
 /**
@@ -342,11 +1652,15 @@ const DataColumn& DataMiner::Data::getColumn(const char* column) const {
  * @param row The row number
  * @returns The data
  */
-const double& DataMiner::Data::getNumber(const char* column, size_t row) const {
-	if (row > nrows)
+double DataMiner::Data::getNumber(const char* column, size_t row) const {
+	if (row >= nrows)
 		throw "Row out of range";
-	size_t i = getIndex(column);
-	return numData[i * nrows + row];
+	const DataColumn& col = getColumn(column);
+	if (col.type != DataType::number)
+		throw "Invalid Data Type Error (Column is a string, number requested)";
+	if (!col.stored)
+		throw "Column was excluded when the dataset was loaded";
+	return numberAt(col, row);
 }
 
 /**
@@ -357,11 +1671,15 @@ const double& DataMiner::Data::getNumber(const char* column, size_t row) const {
  * @param row The row number
  * @returns The data
  */
-const std::string& DataMiner::Data::getString(const char* column, size_t row) const {
-	if (row > nrows)
+std::string_view DataMiner::Data::getString(const char* column, size_t row) const {
+	if (row >= nrows)
 		throw "Row out of range";
-	size_t i = getIndex(column);
-	return strData[i * nrows + row];
+	const DataColumn& col = getColumn(column);
+	if (col.type != DataType::string)
+		throw "Invalid Data Type Error (Column is a number, string requested)";
+	if (!col.stored)
+		throw "Column was excluded when the dataset was loaded";
+	return stringAt(col, row);
 }
 
 /**
@@ -385,11 +1703,15 @@ const DataColumn& DataMiner::Data::getColumn(size_t column) const {
  * @param row The row number
  * @returns The data
  */
-const double& DataMiner::Data::getNumber(size_t column, size_t row) const {
-	if (row > nrows)
+double DataMiner::Data::getNumber(size_t column, size_t row) const {
+	if (row >= nrows)
 		throw "Row out of range";
-	size_t i = getIndex(column);
-	return numData[i * nrows + row];
+	const DataColumn& col = getColumn(column);
+	if (col.type != DataType::number)
+		throw "Invalid Data Type Error (Column is a string, number requested)";
+	if (!col.stored)
+		throw "Column was excluded when the dataset was loaded";
+	return numberAt(col, row);
 }
 
 /**
@@ -400,98 +1722,117 @@ const double& DataMiner::Data::getNumber(size_t column, size_t row) const {
  * @param row The row number
  * @returns The data
  */
-const std::string& DataMiner::Data::getString(size_t column, size_t row) const {
-	if (row > nrows)
+std::string_view DataMiner::Data::getString(size_t column, size_t row) const {
+	if (row >= nrows)
 		throw "Row out of range";
-	size_t i = getIndex(column);
-	return strData[i * nrows + row];
+	const DataColumn& col = getColumn(column);
+	if (col.type != DataType::string)
+		throw "Invalid Data Type Error (Column is a number, string requested)";
+	if (!col.stored)
+		throw "Column was excluded when the dataset was loaded";
+	return stringAt(col, row);
 }
 
 /**
- * Returns a column
+ * Returns numeric data from the dataset without any checks
  * 
- * @throws A string explaining why the process failed
- * @param column The column name
- * @returns The column
+ * @param column A numeric column of the dataset
+ * @param row The row number (must be less than `nrows`)
+ * @returns The data
  */
-DataColumn& DataMiner::Data::getColumn(const char* column) {
-	for (DataColumn& col : cols)
-		if (col.name == column)
-			return col;
-	throw "Column not found error";
+double DataMiner::Data::numberAt(const DataColumn& column, size_t row) const {
+	switch (column.storage) {
+		case NumberStorage::float32: return numbers<const float>(column)[row];
+		case NumberStorage::int32: return widenNumber(numbers<const int32_t>(column)[row]);
+		case NumberStorage::int16: return widenNumber(numbers<const int16_t>(column)[row]);
+		case NumberStorage::int8: return widenNumber(numbers<const int8_t>(column)[row]);
+		default: return numbers<const double>(column)[row];
+	}
 }
 
 /**
- * Returns numeric data from the dataset
+ * Returns string data from the dataset without any checks
  * 
- * @throws A string explaining why the process failed
- * @param column The column name
- * @param row The row number
+ * @param column A string column of the dataset
+ * @param row The row number (must be less than `nrows`)
  * @returns The data
  */
-double& DataMiner::Data::getNumber(const char* column, size_t row) {
-	if (row > nrows)
-		throw "Row out of range";
-	size_t i = getIndex(column);
-	return numData[i * nrows + row];
+std::string_view DataMiner::Data::stringAt(const DataColumn& column, size_t row) const {
+	if (column.encoding == StringEncoding::arena)
+		return arenas[column.index].get(row);
+	return dictionaries[column.index].get(strCodes[column.index * rowCapacity + row]);
 }
 
 /**
- * Returns string data from the dataset
+ * Returns the dictionary code of string data from the dataset (dictionary encoded columns only)
  * 
  * @throws A string explaining why the process failed
- * @param column The column name
+ * @param column The column number
  * @param row The row number
- * @returns The data
+ * @returns The dictionary code of the data
  */
-std::string& DataMiner::Data::getString(const char* column, size_t row) {
-	if (row > nrows)
+uint32_t DataMiner::Data::getCode(size_t column, size_t row) const {
+	if (row >= nrows)
 		throw "Row out of range";
-	size_t i = getIndex(column);
-	return strData[i * nrows + row];
+	const DataColumn& col = getColumn(column);
+	if (col.type != DataType::string || col.encoding != StringEncoding::dictionary)
+		throw "Column is not a dictionary encoded string column";
+	size_t i = getIndex(col);
+	return strCodes[i * rowCapacity + row];
 }
 
 /**
- * Returns a column
+ * Returns the dictionary codes of a dictionary encoded string column, so kernels can work on the codes directly
  * 
  * @throws A string explaining why the process failed
- * @param column The column name
- * @returns The column
+ * @param column The column number
+ * @returns The code of the first row, followed by the other rows in order
  */
-DataColumn& DataMiner::Data::getColumn(size_t column) {
-	if (column >= cols.size())
-		throw "Column not found error";
-	return cols[column];
+const uint32_t* DataMiner::Data::getCodes(size_t column) const {
+	const DataColumn& col = getColumn(column);
+	if (col.type != DataType::string || col.encoding != StringEncoding::dictionary)
+		throw "Column is not a dictionary encoded string column";
+	if (!col.stored)
+		throw "Column was excluded when the dataset was loaded";
+	return strCodes + getIndex(col) * rowCapacity;
 }
 
 /**
- * Returns numeric data from the dataset
+ * Returns the dictionary of a dictionary encoded string column, which maps the column's strings to codes and back
+ * 
+ * @throws A string explaining why the process failed
+ * @param column The column number
+ * @returns The dictionary of the column
+ */
+const StringDictionary& DataMiner::Data::getDictionary(size_t column) const {
+	const DataColumn& col = getColumn(column);
+	if (col.type != DataType::string || col.encoding != StringEncoding::dictionary)
+		throw "Column is not a dictionary encoded string column";
+	return dictionaries[getIndex(col)];
+}
+
+/**
+ * Returns a column
  * 
  * @throws A string explaining why the process failed
  * @param column The column name
- * @param row The row number
- * @returns The data
+ * @returns The column
  */
-double& DataMiner::Data::getNumber(size_t column, size_t row) {
-	if (row > nrows)
-		throw "Row out of range";
-	size_t i = getIndex(column);
-	return numData[i * nrows + row];
+DataColumn& DataMiner::Data::getColumn(const char* column) {
+	return cols[findColumn(column)];
 }
 
 /**
- * Returns string data from the dataset
+ * Returns a column
  * 
  * @throws A string explaining why the process failed
  * @param column The column name
- * @param row The row number
- * @returns The data
+ * @returns The column
  */
-std::string& DataMiner::Data::getString(size_t column, size_t row) {
-	if (row > nrows)
-		throw "Row out of range";
-	size_t i = getIndex(column);
-	return strData[i * nrows + row];
+DataColumn& DataMiner::Data::getColumn(size_t column) {
+	if (column >= cols.size())
+		throw "Column not found error";
+	return cols[column];
 }
 
 /**
@@ -539,21 +1880,225 @@ void DataMiner::Data::setTarget(DataColumn& column) {
 const DataRow DataMiner::Data::getRow(size_t row) const {
 	if (row >= nrows)
 		throw "Row is out of bounds";
-	std::vector<std::string> strDat;
-	std::vector<double> numDat;
+	return DataRow(*this, row);
+}
 
-	size_t colIndex = 0;
+/**
+ * Sorts the rows of the dataset by every numeric feature column (in parallel across columns), so split searches can
+ * scan the rows in order instead of sorting them again
+ * 
+ * @throws A string explaining why the process failed
+ */
+void DataMiner::Data::sortNumericColumns() {
+	if (nrows > UINT32_MAX)
+		throw "Too many rows to sort";
+
+	std::vector<const DataColumn*> pending;
+	sortedRows.resize(numSketches.size());
+	for (const DataColumn& col : cols)
+		if (col.stored && col.type == DataType::number && col.role == DataRole::feature && sortedRows[col.index].size() != nrows)
+			pending.push_back(&col);
+
+	forEachColumn(pending, [this](const DataColumn& col) {
+		// Values are sorted in their storage type, narrow columns move less memory
+		visitNumbers(col, [this, &col](const auto* values) {
+			using Value = std::remove_const_t<std::remove_pointer_t<decltype(values)>>;
+			std::vector<std::pair<Value, uint32_t>> entries;
+			entries.reserve(nrows);
+			for (uint32_t row = 0; row < nrows; row++)
+				entries.emplace_back(values[row], row);
+
+			// Missing values cannot be ordered, they go after every other value
+			auto missing = std::stable_partition(entries.begin(), entries.end(), [](const std::pair<Value, uint32_t>& entry) {
+				return !isMissingNumber(entry.first);
+			});
+			std::sort(entries.begin(), missing);
+
+			std::vector<uint32_t>& rows = sortedRows[col.index];
+			rows.resize(nrows);
+			for (size_t i = 0; i < entries.size(); i++)
+				rows[i] = entries[i].second;
+		});
+	});
+}
+
+/**
+ * Returns the rows of the dataset ordered by the values of a numeric column, rows with missing values come last
+ * (`sortNumericColumns` must have been called)
+ * 
+ * @throws A string explaining why the process failed
+ * @param column The column number
+ * @returns The row numbers in order
+ */
+const std::vector<uint32_t>& DataMiner::Data::getSortedRows(size_t column) const {
+	const DataColumn& col = getColumn(column);
+	if (col.type != DataType::number)
+		throw "Column is not a numeric column";
+	size_t i = getIndex(col);
+	if (i >= sortedRows.size() || sortedRows[i].size() != nrows)
+		throw "The rows have not been sorted by this column";
+	return sortedRows[i];
+}
+
+/**
+ * Quantizes every numeric feature column (in parallel across columns) into quantile bins of roughly equal row counts,
+ * so split searches can build small histograms of bins instead of scanning raw values
+ * 
+ * @throws A string explaining why the process failed
+ * @param maxBins The most bins per column, at most 255 (columns with fewer distinct values get one bin per value)
+ */
+void DataMiner::Data::binNumericColumns(size_t maxBins) {
+	if (maxBins == 0 || maxBins > missingBin)
+		throw "Numeric columns can be split into 1 to 255 bins";
+
+	std::vector<const DataColumn*> pending;
+	bins.assign(numSketches.size(), {});
+	binEdges.assign(numSketches.size(), {});
+	for (const DataColumn& col : cols)
+		if (col.stored && col.type == DataType::number && col.role == DataRole::feature)
+			pending.push_back(&col);
+
+	forEachColumn(pending, [this, maxBins](const DataColumn& col) {
+		visitNumbers(col, [this, maxBins, &col](const auto* values) {
+			using Value = std::remove_const_t<std::remove_pointer_t<decltype(values)>>;
+			std::vector<Value> sorted;
+			sorted.reserve(nrows - col.nullCount);
+			for (size_t row = 0; row < nrows; row++)
+				if (!isMissingNumber(values[row]))
+					sorted.push_back(values[row]);
+			std::sort(sorted.begin(), sorted.end());
+
+			// Each distinct value gets its own bin when there are few enough, otherwise the edges are evenly spaced quantiles
+			std::vector<double>& edges = binEdges[col.index];
+			std::unique_copy(sorted.begin(), sorted.end(), std::back_inserter(edges));
+			if (edges.size() > maxBins) {
+				edges.clear();
+				for (size_t bin = 1; bin <= maxBins; bin++) {
+					double edge = sorted[(bin * sorted.size() + maxBins - 1) / maxBins - 1];
+					if (edges.empty() || edge > edges.back())
+						edges.push_back(edge);
+				}
+			}
+
+			std::vector<uint8_t>& rows = bins[col.index];
+			rows.resize(nrows);
+			for (size_t row = 0; row < nrows; row++) {
+				if (isMissingNumber(values[row]))
+					rows[row] = missingBin;
+				else
+					rows[row] = static_cast<uint8_t>(std::lower_bound(edges.begin(), edges.end(), static_cast<double>(values[row])) - edges.begin());
+			}
+		});
+	});
+}
+
+/**
+ * Adds the rows appended after a row to the sorted row indexes and quantile bins which were already built
+ * 
+ * @throws A string explaining why the process failed
+ * @param firstRow The first appended row
+ */
+void DataMiner::Data::extendIndexes(size_t firstRow) {
+	if (nrows > UINT32_MAX) {
+		sortedRows.clear();
+		return;
+	}
+
+	std::vector<const DataColumn*> sorted;
+	std::vector<const DataColumn*> binned;
 	for (const DataColumn& col : cols) {
-		if (col.type == DataType::string) {
-			strDat.push_back(getString(colIndex, row));
-		}
-		if (col.type == DataType::number) {
-			numDat.push_back(getNumber(colIndex, row));
-		}
-		colIndex++;
+		if (!col.stored || col.type != DataType::number)
+			continue;
+		if (col.index < sortedRows.size() && sortedRows[col.index].size() == firstRow && firstRow != 0)
+			sorted.push_back(&col);
+		if (col.index < bins.size() && bins[col.index].size() == firstRow && firstRow != 0)
+			binned.push_back(&col);
 	}
 
-	return DataRow(cols, strDat, numDat);
+	// Only the new rows are sorted, then they are merged into the existing order
+	forEachColumn(sorted, [this, firstRow](const DataColumn& col) {
+		visitNumbers(col, [this, firstRow, &col](const auto* values) {
+			auto before = [values](uint32_t a, uint32_t b) {
+				return values[a] < values[b] || (values[a] == values[b] && a < b);
+			};
+			auto present = [values](uint32_t row) {
+				return !isMissingNumber(values[row]);
+			};
+
+			std::vector<uint32_t> added(nrows - firstRow);
+			for (size_t i = 0; i < added.size(); i++)
+				added[i] = static_cast<uint32_t>(firstRow + i);
+			auto addedMissing = std::stable_partition(added.begin(), added.end(), present);
+			std::sort(added.begin(), addedMissing, before);
+
+			// Missing values stay after every other value
+			std::vector<uint32_t>& rows = sortedRows[col.index];
+			auto rowsMissing = std::partition_point(rows.begin(), rows.end(), present);
+			std::vector<uint32_t> merged;
+			merged.reserve(nrows);
+			std::merge(rows.begin(), rowsMissing, added.begin(), addedMissing, std::back_inserter(merged), before);
+			merged.insert(merged.end(), rowsMissing, rows.end());
+			merged.insert(merged.end(), addedMissing, added.end());
+			rows = std::move(merged);
+		});
+	});
+
+	// New rows are binned with the existing edges, the last bin grows to hold values past it
+	forEachColumn(binned, [this, firstRow](const DataColumn& col) {
+		visitNumbers(col, [this, firstRow, &col](const auto* values) {
+			std::vector<double>& edges = binEdges[col.index];
+			std::vector<uint8_t>& rows = bins[col.index];
+			rows.resize(nrows);
+			for (size_t row = firstRow; row < nrows; row++) {
+				if (isMissingNumber(values[row])) {
+					rows[row] = missingBin;
+					continue;
+				}
+				double value = static_cast<double>(values[row]);
+				if (edges.empty())
+					edges.push_back(value);
+				else if (value > edges.back())
+					edges.back() = value;
+				rows[row] = static_cast<uint8_t>(std::lower_bound(edges.begin(), edges.end(), value) - edges.begin());
+			}
+		});
+	});
+}
+
+/**
+ * Returns the quantile bin of every row for a numeric column, rows with missing values are in `missingBin`
+ * (`binNumericColumns` must have been called)
+ * 
+ * @throws A string explaining why the process failed
+ * @param column The column number
+ * @returns The bin of each row
+ */
+const std::vector<uint8_t>& DataMiner::Data::getBins(size_t column) const {
+	const DataColumn& col = getColumn(column);
+	if (col.type != DataType::number)
+		throw "Column is not a numeric column";
+	size_t i = getIndex(col);
+	if (i >= bins.size() || bins[i].size() != nrows)
+		throw "The rows have not been binned by this column";
+	return bins[i];
+}
+
+/**
+ * Returns the largest value in each quantile bin of a numeric column, a row is in the first bin whose edge is not less
+ * than its value (`binNumericColumns` must have been called)
+ * 
+ * @throws A string explaining why the process failed
+ * @param column The column number
+ * @returns The edge of each bin
+ */
+const std::vector<double>& DataMiner::Data::getBinEdges(size_t column) const {
+	const DataColumn& col = getColumn(column);
+	if (col.type != DataType::number)
+		throw "Column is not a numeric column";
+	size_t i = getIndex(col);
+	if (i >= bins.size() || bins[i].size() != nrows)
+		throw "The rows have not been binned by this column";
+	return binEdges[i];
 }
 
 /**
@@ -570,21 +2115,12 @@ const DataColumn& DataMiner::Data::getTarget() const {
 }
 
 /**
- * Creates a new data row given the columns
- * 
- * @param columns A reference to the columns of the dataset
- */
-DataMiner::DataRow::DataRow(const std::vector<DataColumn>& columns) : columns(columns) {}
-
-/**
- * Creates a new data row given the columns and data
+ * Creates a view of a row of a dataset
  * 
- * @param columns A reference to the columns of the dataset
- * @param strData The string data of the row
- * @param numData The numerical data of the row
+ * @param dataset The dataset the row belongs to
+ * @param row The index of the row within the dataset
  */
-DataMiner::DataRow::DataRow(const std::vector<DataColumn>& columns, const std::vector<std::string>& strData, const std::vector<double>& numData) :
-	columns(columns), strData(strData), numData(numData) {}
+DataMiner::DataRow::DataRow(const Data& dataset, size_t row) : dataset(dataset), row(row), owning(false) {}
 
 /**
  * Creates a sample data row given the dataset to connect to and all row data
@@ -593,19 +2129,19 @@ DataMiner::DataRow::DataRow(const std::vector<DataColumn>& columns, const std::v
  * @param dataset The dataset to connect to
  * @param data The data this row will contain
  */
-DataMiner::DataRow::DataRow(const Data& dataset, const std::vector<std::tuple<std::string, double>>& data) : columns(dataset.cols) {
+DataMiner::DataRow::DataRow(const Data& dataset, const std::vector<std::tuple<std::string, double>>& data) :
+	strData(data.size()), numData(data.size()), dataset(dataset), row(0), owning(true) {
+	const std::vector<DataColumn>& columns = dataset.cols;
 	if (columns.size() != data.size())
 		throw "Data length and columns length are not equal";
 	
-	size_t i = 0;
-	for (auto dataTuple : data) {
+	for (size_t i = 0; i < data.size(); i++) {
 		if (columns[i].type == DataType::string) {
-			strData.push_back(std::get<0>(dataTuple));
+			strData[i] = std::get<0>(data[i]);
 		}
 		if (columns[i].type == DataType::number) {
-			numData.push_back(std::get<1>(dataTuple));
+			numData[i] = std::get<1>(data[i]);
 		}
-		i++;
 	}
 }
 
@@ -615,11 +2151,8 @@ DataMiner::DataRow::DataRow(const Data& dataset, const std::vector<std::tuple<st
  * @throws A string representing why the operation failed
  * @param column The column to retrieve from
  */
-const std::string& DataMiner::DataRow::getString(const char* column) const {
-	for (const DataColumn& col : columns)
-		if (col.name == column)
-			return getString(col);
-	throw "Column not found error";
+std::string_view DataMiner::DataRow::getString(const char* column) const {
+	return getString(dataset.findColumn(column));
 }
 
 /**
@@ -628,10 +2161,15 @@ const std::string& DataMiner::DataRow::getString(const char* column) const {
  * @throws A string representing why the operation failed
  * @param column The column to retrieve from
  */
-const std::string& DataMiner::DataRow::getString(size_t column) const {
-	if (column >= columns.size())
-		throw "Column not found error";
-	return getString(columns[column]);
+std::string_view DataMiner::DataRow::getString(size_t column) const {
+	const DataColumn& col = dataset.getColumn(column);
+	if (col.type != DataType::string)
+		throw "Invalid Data Type Error (Column is a number, string requested)";
+	if (!col.stored)
+		throw "Column was excluded when the dataset was loaded";
+	if (owning)
+		return strData[column];
+	return dataset.stringAt(col, row);
 }
 
 /**
@@ -640,22 +2178,8 @@ const std::string& DataMiner::DataRow::getString(size_t column) const {
  * @throws A string representing why the operation failed
  * @param column The column to retrieve from
  */
-const std::string& DataMiner::DataRow::getString(const DataColumn& column) const {
-	size_t index = 0;
-	bool found = false;
-	for (const DataColumn& col : columns) {
-		if (&col == &column) {
-			found = true;
-			break;
-		}
-		if (col.type == column.type)
-			index++;
-	}
-
-	if (!found)
-		throw "Column not found error";
-	
-	return strData[index];
+std::string_view DataMiner::DataRow::getString(const DataColumn& column) const {
+	return getString(dataset.findColumn(column));
 }
 
 /**
@@ -664,11 +2188,8 @@ const std::string& DataMiner::DataRow::getString(const DataColumn& column) const
  * @throws A string representing why the operation failed
  * @param column The column to retrieve from
  */
-const double& DataMiner::DataRow::getNumber(const char* column) const {
-	for (const DataColumn& col : columns)
-		if (col.name == column)
-			return getNumber(col);
-	throw "Column not found error";
+double DataMiner::DataRow::getNumber(const char* column) const {
+	return getNumber(dataset.findColumn(column));
 }
 
 /**
@@ -677,10 +2198,15 @@ const double& DataMiner::DataRow::getNumber(const char* column) const {
  * @throws A string representing why the operation failed
  * @param column The column to retrieve from
  */
-const double& DataMiner::DataRow::getNumber(size_t column) const {
-	if (column >= columns.size())
-		throw "Column not found error";
-	return getNumber(columns[column]);
+double DataMiner::DataRow::getNumber(size_t column) const {
+	const DataColumn& col = dataset.getColumn(column);
+	if (col.type != DataType::number)
+		throw "Invalid Data Type Error (Column is a string, number requested)";
+	if (!col.stored)
+		throw "Column was excluded when the dataset was loaded";
+	if (owning)
+		return numData[column];
+	return dataset.numberAt(col, row);
 }
 
 /**
@@ -689,18 +2215,6 @@ const double& DataMiner::DataRow::getNumber(size_t column) const {
  * @throws A string representing why the operation failed
  * @param column The column to retrieve from
  */
-const double& DataMiner::DataRow::getNumber(const DataColumn& column) const {
-	size_t index = 0;
-	bool found = false;
-	for (const DataColumn& col : columns) {
-		if (&col == &column)
-			found = true;
-		if (col.type == column.type)
-			index++;
-	}
-
-	if (!found)
-		throw "Column not found error";
-	
-	return numData[index];
+double DataMiner::DataRow::getNumber(const DataColumn& column) const {
+	return getNumber(dataset.findColumn(column));
 }
\ No newline at end of file
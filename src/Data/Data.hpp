@@ -16,7 +16,18 @@
 
 #pragma once
 
+#include <Data/HyperLogLog.hpp>
+#include <Data/StringArena.hpp>
+#include <Data/StringDictionary.hpp>
+#include <cstdint>
 #include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 /**
@@ -24,6 +35,13 @@
  */
 namespace DataMiner {
 
+	class ColumnAllocator;
+	class Data;
+	class MappedFile;
+	class RowSampler;
+	struct CsvChunk;
+	struct CsvLoadReport;
+
 	/**
 	 * All supported base data types in datasets for mining
 	 */
@@ -41,6 +59,88 @@ namespace DataMiner {
 		excluded
 	};
 
+	/**
+	 * How the values of a string column are stored
+	 */
+	enum class StringEncoding {
+		dictionary,
+		arena
+	};
+
+	/**
+	 * How the values of a numeric column are stored, the narrowest of these which holds every value of the column
+	 * exactly is picked once the column is loaded
+	 * 
+	 * Integer types mark missing values with their smallest value (which is never used for data), floating point types
+	 * with NaN
+	 */
+	enum class NumberStorage {
+		float64,
+		float32,
+		int32,
+		int16,
+		int8
+	};
+
+	/**
+	 * Returns the size of a single value of a numeric storage type
+	 * 
+	 * @param storage The storage type
+	 * @returns The size in bytes
+	 */
+	constexpr size_t numberStorageSize(NumberStorage storage) {
+		switch (storage) {
+			case NumberStorage::float32: return sizeof(float);
+			case NumberStorage::int32: return sizeof(int32_t);
+			case NumberStorage::int16: return sizeof(int16_t);
+			case NumberStorage::int8: return sizeof(int8_t);
+			default: return sizeof(double);
+		}
+	}
+
+	/**
+	 * Returns the storage type which stores values as a specific C++ type
+	 * 
+	 * @returns The storage type
+	 */
+	template <typename T> constexpr NumberStorage numberStorageOf() {
+		static_assert(std::is_same_v<T, double> || std::is_same_v<T, float> || std::is_same_v<T, int32_t> || std::is_same_v<T, int16_t> ||
+			std::is_same_v<T, int8_t>, "Unsupported numeric storage type");
+		if constexpr (std::is_same_v<T, double>)
+			return NumberStorage::float64;
+		else if constexpr (std::is_same_v<T, float>)
+			return NumberStorage::float32;
+		else if constexpr (std::is_same_v<T, int32_t>)
+			return NumberStorage::int32;
+		else if constexpr (std::is_same_v<T, int16_t>)
+			return NumberStorage::int16;
+		else
+			return NumberStorage::int8;
+	}
+
+	/**
+	 * Checks whether a stored numeric value is a missing value
+	 * 
+	 * @param value The stored value
+	 * @returns Whether or not the value is missing
+	 */
+	template <typename T> constexpr bool isMissingNumber(T value) {
+		if constexpr (std::is_floating_point_v<T>)
+			return value != value;
+		else
+			return value == std::numeric_limits<T>::min();
+	}
+
+	/**
+	 * Converts a stored numeric value back to a double (missing values become NaN)
+	 * 
+	 * @param value The stored value
+	 * @returns The value
+	 */
+	template <typename T> constexpr double widenNumber(T value) {
+		return isMissingNumber(value) ? std::numeric_limits<double>::quiet_NaN() : static_cast<double>(value);
+	}
+
 	/**
 	 * Represents a column in the dataset
 	 */
@@ -60,17 +160,61 @@ namespace DataMiner {
 		 */
 		DataRole role;
 
+		/**
+		 * How the values of the column are stored (string columns only)
+		 */
+		StringEncoding encoding;
+
+		/**
+		 * How the values of the column are stored (numeric columns only)
+		 */
+		NumberStorage storage;
+
+		/**
+		 * The index of the column among the dataset's stored columns of the same type and string encoding, which is
+		 * where its values live in the dataset's storage
+		 */
+		size_t index;
+
+		/**
+		 * Whether the dataset stores the values of the column (excluded columns are skipped while loading)
+		 */
+		bool stored;
+
+		/**
+		 * The smallest value in the column (numeric columns only, NaN if the column has no values)
+		 */
+		double min;
+
+		/**
+		 * The largest value in the column (numeric columns only, NaN if the column has no values)
+		 */
+		double max;
+
+		/**
+		 * The amount of missing values in the column (empty cells, and numeric cells which are not numbers)
+		 */
+		size_t nullCount;
+
+		/**
+		 * The amount of distinct values in the column other than missing values (exact for dictionary encoded columns,
+		 * estimated by a HyperLogLog sketch for the others)
+		 */
+		size_t distinctCount;
+
 		/**
 		 * Creates a new data column
 		 */
-		DataColumn() : type(DataType::string), name(""), role(DataRole::feature) {}
+		DataColumn() : type(DataType::string), name(""), role(DataRole::feature), encoding(StringEncoding::dictionary), storage(NumberStorage::float64), index(0), stored(true),
+			min(std::numeric_limits<double>::quiet_NaN()), max(std::numeric_limits<double>::quiet_NaN()), nullCount(0), distinctCount(0) {}
 
 		/**
 		 * Creates a new data column given the type
 		 * 
 		 * @param type The data type
 		 */
-		DataColumn(DataType type) : type(type), name(""), role(DataRole::feature) {}
+		DataColumn(DataType type) : type(type), name(""), role(DataRole::feature), encoding(StringEncoding::dictionary), storage(NumberStorage::float64), index(0), stored(true),
+			min(std::numeric_limits<double>::quiet_NaN()), max(std::numeric_limits<double>::quiet_NaN()), nullCount(0), distinctCount(0) {}
 
 		/**
 		 * Creates a new data column given the type, and role
@@ -78,7 +222,8 @@ namespace DataMiner {
 		 * @param type The data type
 		 * @param role The role of the column
 		 */
-		DataColumn(DataType type, DataRole role) : type(type), name(""), role(role) {}
+		DataColumn(DataType type, DataRole role) : type(type), name(""), role(role), encoding(StringEncoding::dictionary), storage(NumberStorage::float64), index(0), stored(true),
+			min(std::numeric_limits<double>::quiet_NaN()), max(std::numeric_limits<double>::quiet_NaN()), nullCount(0), distinctCount(0) {}
 
 		/**
 		 * Creates a new data column given the name, type, and role
@@ -87,7 +232,8 @@ namespace DataMiner {
 		 * @param name The name of the column
 		 * @param role The role of the column
 		 */
-		DataColumn(DataType type, const char* name, DataRole role) : type(type), name(name), role(role) {}
+		DataColumn(DataType type, const char* name, DataRole role) : type(type), name(name), role(role), encoding(StringEncoding::dictionary), storage(NumberStorage::float64), index(0), stored(true),
+			min(std::numeric_limits<double>::quiet_NaN()), max(std::numeric_limits<double>::quiet_NaN()), nullCount(0), distinctCount(0) {}
 
 		/**
 		 * Checks if the struct is equal to another
@@ -106,40 +252,45 @@ namespace DataMiner {
 
 	/**
 	 * Represents a single row inside of a dataset
+	 * 
+	 * Rows returned by a dataset are views which read straight from the dataset's storage (and are only valid as long
+	 * as the dataset is), only rows built from tuples own their values
 	 */
 	struct DataRow {
 	private:
 
 		/**
-		 * The string data of the row
+		 * The string data of the row, indexed by column (owning rows only)
 		 */
 		std::vector<std::string> strData;
 
 		/**
-		 * The numerical data of the row
+		 * The numerical data of the row, indexed by column (owning rows only)
 		 */
 		std::vector<double> numData;
 
 		/**
-		 * The columns of the dataset (direct reference)
+		 * The dataset the row belongs to (direct reference)
 		 */
-		const std::vector<DataColumn>& columns;
+		const Data& dataset;
 
 		/**
-		 * Creates a new data row given the columns
-		 * 
-		 * @param columns A reference to the columns of the dataset
+		 * The index of the row within the dataset (views only)
 		 */
-		DataRow(const std::vector<DataColumn>& columns);
+		size_t row;
 
 		/**
-		 * Creates a new data row given the columns and data
+		 * Whether the row owns its values rather than viewing a row of the dataset
+		 */
+		bool owning;
+
+		/**
+		 * Creates a view of a row of a dataset
 		 * 
-		 * @param columns A reference to the columns of the dataset
-		 * @param strData The string data of the row
-		 * @param numData The numerical data of the row
+		 * @param dataset The dataset the row belongs to
+		 * @param row The index of the row within the dataset
 		 */
-		DataRow(const std::vector<DataColumn>& columns, const std::vector<std::string>& strData, const std::vector<double>& numData);
+		DataRow(const Data& dataset, size_t row);
 
 		friend class Data;
 	public:
@@ -158,7 +309,7 @@ namespace DataMiner {
 		 * @throws A string representing why the operation failed
 		 * @param column The column to retrieve from
 		 */
-		const std::string& getString(const char* column) const;
+		std::string_view getString(const char* column) const;
 
 		/**
 		 * Gets string data from the row
@@ -166,7 +317,7 @@ namespace DataMiner {
 		 * @throws A string representing why the operation failed
 		 * @param column The column to retrieve from
 		 */
-		const std::string& getString(size_t column) const;
+		std::string_view getString(size_t column) const;
 
 		/**
 		 * Gets string data from the row
@@ -174,7 +325,7 @@ namespace DataMiner {
 		 * @throws A string representing why the operation failed
 		 * @param column The column to retrieve from
 		 */
-		const std::string& getString(const DataColumn& column) const;
+		std::string_view getString(const DataColumn& column) const;
 
 		/**
 		 * Gets double data from the row
@@ -182,7 +333,7 @@ namespace DataMiner {
 		 * @throws A string representing why the operation failed
 		 * @param column The column to retrieve from
 		 */
-		const double& getNumber(const char* column) const;
+		double getNumber(const char* column) const;
 
 		/**
 		 * Gets double data from the row
@@ -190,7 +341,7 @@ namespace DataMiner {
 		 * @throws A string representing why the operation failed
 		 * @param column The column to retrieve from
 		 */
-		const double& getNumber(size_t column) const;
+		double getNumber(size_t column) const;
 
 		/**
 		 * Gets double data from the row
@@ -198,7 +349,7 @@ namespace DataMiner {
 		 * @throws A string representing why the operation failed
 		 * @param column The column to retrieve from
 		 */
-		const double& getNumber(const DataColumn& column) const;
+		double getNumber(const DataColumn& column) const;
 	};
 	
 	/**
@@ -213,20 +364,67 @@ namespace DataMiner {
 		std::ifstream file;
 
 		/**
-		 * Stores strings from the dataset
+		 * Stores the dictionary codes of strings from the dataset (dictionary encoded columns only)
+		 */
+		uint32_t* strCodes;
+
+		/**
+		 * The dictionary of every dictionary encoded string column (string values are stored as codes into these)
+		 */
+		std::vector<StringDictionary> dictionaries;
+
+		/**
+		 * The strings of every arena encoded string column
+		 */
+		std::vector<StringArena> arenas;
+
+		/**
+		 * Stores numeric values from the dataset, each column in its own storage type
+		 */
+		char* numData;
+
+		/**
+		 * The byte offset of every stored numeric column within `numData`
 		 */
-		std::string* strData;
+		std::vector<size_t> numOffsets;
 
 		/**
-		 * Stores numeric values from the dataset
+		 * The rows of every stored numeric column ordered by the column's values (missing values last), empty for
+		 * columns which have not been sorted
 		 */
-		double* numData;
+		std::vector<std::vector<uint32_t>> sortedRows;
+
+		/**
+		 * The quantile bin of every row of every stored numeric column, empty for columns which have not been binned
+		 */
+		std::vector<std::vector<uint8_t>> bins;
+
+		/**
+		 * The largest value in each quantile bin of every stored numeric column
+		 */
+		std::vector<std::vector<double>> binEdges;
+
+		/**
+		 * The distinct value sketch of every stored numeric column
+		 */
+		std::vector<HyperLogLog> numSketches;
+
+		/**
+		 * The distinct value sketch of every arena encoded string column
+		 */
+		std::vector<HyperLogLog> arenaSketches;
 
 		/**
 		 * The number of rows in the dataset
 		 */
 		size_t nrows;
 
+		/**
+		 * The amount of rows the column buffers have room for, which is also the distance between the starts of two
+		 * columns in the buffers
+		 */
+		size_t rowCapacity;
+
 		/**
 		 * The number of columns in the dataset
 		 */
@@ -237,37 +435,240 @@ namespace DataMiner {
 		 */
 		std::vector<DataColumn> cols;
 
+		/**
+		 * Maps the names of the columns to their positions in `cols` (the keys view the names stored in `cols`)
+		 */
+		std::unordered_map<std::string_view, size_t> names;
+
+		/**
+		 * Whether or not the first row of the file is a header
+		 */
+		bool hasHeader;
+
+		/**
+		 * The csv file the dataset was loaded from
+		 */
+		std::string source;
+
+		/**
+		 * How many bytes of `source` have been read into the dataset, the maximum size_t if the file cannot be followed
+		 * as it grows (compressed files, pipes and samples)
+		 */
+		size_t sourceBytes;
+
+		/**
+		 * Whether only a random sample of the rows of the file was loaded
+		 */
+		bool sampled;
+
+		/**
+		 * The binary cache the column buffers point into, null if the buffers were allocated on the heap
+		 */
+		MappedFile* cache;
+
+		/**
+		 * The allocator the column buffers were allocated with
+		 */
+		ColumnAllocator* allocator;
+
+		/**
+		 * The sizes the numeric and dictionary code buffers were allocated with
+		 */
+		size_t numDataBytes, strCodesBytes;
+
+		/**
+		 * Frees the column buffers (or unmaps the cache they point into)
+		 */
+		void freeBuffers();
+
 		/**
 		 * Loads a csv file (assumes .csv file extension)
 		 * 
 		 * @throws A string with a description of why the process failed
 		 */
 		void loadCsv(const char* filename);
+
+		/**
+		 * Reads the columns of a csv file from its first row(s), asking the user about the header and column roles
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param cursor The first byte of the csv data, advanced past the header row if there is one
+		 * @param end One past the last byte of the csv data
+		 */
+		void readCsvSchema(const char*& cursor, const char* end);
+
+		/**
+		 * Writes the parsed dataset to a binary cache file next to the csv file, so later loads can skip parsing
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param filename The name of the csv file
+		 */
+		void saveCache(const char* filename) const;
+
+		/**
+		 * Loads the dataset from the binary cache file of a csv file, mapping its column buffers directly
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param filename The name of the csv file
+		 * @returns Whether or not an up to date cache was found and loaded
+		 */
+		bool loadCache(const char* filename);
+
+		/**
+		 * Asks the user which roles the columns should have, then lists the columns
+		 * 
+		 * @throws A string with a description of why the process failed
+		 */
+		void promptRoles();
+
+		/**
+		 * Loads the rows of a block of csv data into the dataset, replacing any rows loaded before
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param cursor The first byte of the rows (must be the start of a row)
+		 * @param end One past the last byte of the rows
+		 */
+		void loadCsvRows(const char* cursor, const char* end);
+
+		/**
+		 * Loads csv data from a stream which can only be read once (such as a pipe), growing the column buffers as
+		 * rows arrive
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param input The stream to read from
+		 * @param append Whether to add the rows after the dataset's rows (the stream's columns must match the dataset's)
+		 *   instead of reading the columns from the stream and replacing the rows
+		 */
+		void loadCsvStream(std::istream& input, bool append);
+
+		/**
+		 * Skips the header row of csv data being appended to the dataset, checking it names the dataset's columns
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param cursor The first byte of the csv data, advanced past the header row if the dataset has one
+		 * @param end One past the last byte of the csv data
+		 */
+		void skipCsvHeader(const char*& cursor, const char* end) const;
+
+		/**
+		 * Adds the rows appended after a row to the sorted row indexes and quantile bins which were already built
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param firstRow The first appended row
+		 */
+		void extendIndexes(size_t firstRow);
+
+		/**
+		 * Asks the user whether to load only a random sample of the rows
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @returns The sampler to pass the rows through, null to load every row
+		 */
+		std::unique_ptr<RowSampler> promptSample() const;
+
+		/**
+		 * Loads the rows kept by a sampler, replacing the rows of the dataset
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param sampler The sampler every row of the file was offered to
+		 */
+		void loadCsvSample(RowSampler& sampler);
+
+		/**
+		 * Removes all rows from the dataset, keeping its columns
+		 */
+		void clearRows();
+
+		/**
+		 * Makes sure the column buffers have room for an amount of rows, growing them geometrically
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param rows The amount of rows the buffers need room for
+		 */
+		void reserveRows(size_t rows);
+
+		/**
+		 * Parses the rows of a block of csv data and adds them after the rows already in the dataset
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param cursor The first byte of the rows (must be the start of a row)
+		 * @param end One past the last byte of the rows
+		 * @param report Collects the thread count and malformed cells of the load
+		 */
+		void appendCsvRows(const char* cursor, const char* end, CsvLoadReport& report);
+
+		/**
+		 * Logs how many rows were loaded, and the cells which could not be read as numbers
+		 * 
+		 * @param report The report of the load
+		 */
+		void reportCsvLoad(const CsvLoadReport& report) const;
+
+		/**
+		 * Parses the rows of a line aligned chunk of csv data into the dataset's buffers
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param chunk The chunk to parse, which receives the chunk's own string dictionaries/arenas and malformed cells
+		 */
+		void parseCsvChunk(CsvChunk& chunk);
+
+		/**
+		 * Chooses how each string column is stored from the amount of distinct values in the first rows of the data
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param begin The first byte of the csv data (must be the start of a row)
+		 * @param end One past the last byte of the csv data
+		 */
+		void chooseStringEncodings(const char* begin, const char* end);
 		
 		/**
-		 * Gets the index of the column within the specific datatype (useful for retrieving data)
+		 * Works out which columns are stored and the storage index of every stored column, and rebuilds the column
+		 * name lookup, must be called whenever columns are added or their types, roles or string encodings change
+		 */
+		void indexColumns();
+
+		/**
+		 * Finds the position of a column within the dataset
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param column The column name
+		 * @returns The position of the column
+		 */
+		size_t findColumn(const char* column) const;
+
+		/**
+		 * Finds the position of a column within the dataset
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param column The column, which must belong to this dataset
+		 * @returns The position of the column
+		 */
+		size_t findColumn(const DataColumn& column) const;
+
+		/**
+		 * Gets the index of the column within the specific datatype and string encoding (useful for retrieving data)
 		 * 
 		 * @throws A string with a description of why the process failed
 		 * @param column The column whose index to retrieve
-		 * @returns The index of the column within the datatype
+		 * @returns The index of the column within the datatype and string encoding
 		 */
 		size_t getIndex(const char* column) const;
 		
 		/**
-		 * Gets the index of the column within the specific datatype (useful for retrieving data)
+		 * Gets the index of the column within the specific datatype and string encoding (useful for retrieving data)
 		 * 
 		 * @throws A string with a description of why the process failed
 		 * @param column The column whose index to retrieve
-		 * @returns The index of the column within the datatype
+		 * @returns The index of the column within the datatype and string encoding
 		 */
 		size_t getIndex(size_t column) const;
 		
 		/**
-		 * Gets the index of the column within the specific datatype (useful for retrieving data)
+		 * Gets the index of the column within the specific datatype and string encoding (useful for retrieving data)
 		 * 
 		 * @throws A string with a description of why the process failed
 		 * @param column The column whose index to retrieve
-		 * @returns The index of the column within the datatype
+		 * @returns The index of the column within the datatype and string encoding
 		 */
 		size_t getIndex(const DataColumn& column) const;
 
@@ -281,24 +682,76 @@ namespace DataMiner {
 		DataColumn& getColumn(const char* column);
 
 		/**
-		 * Returns numeric data from the dataset
+		 * Returns numeric data from the dataset without any checks
 		 * 
-		 * @throws A string with a description of why the process failed
-		 * @param column The column name
-		 * @param row The row number
+		 * @param column A numeric column of the dataset
+		 * @param row The row number (must be less than `nrows`)
 		 * @returns The data
 		 */
-		double& getNumber(const char* column, size_t row);
+		double numberAt(const DataColumn& column, size_t row) const;
 
 		/**
-		 * Returns string data from the dataset
+		 * Returns string data from the dataset without any checks
 		 * 
-		 * @throws A string with a description of why the process failed
-		 * @param column The column name
-		 * @param row The row number
+		 * @param column A string column of the dataset
+		 * @param row The row number (must be less than `nrows`)
 		 * @returns The data
 		 */
-		std::string& getString(const char* column, size_t row);
+		std::string_view stringAt(const DataColumn& column, size_t row) const;
+
+		/**
+		 * Returns the values of a numeric column without any checks
+		 * 
+		 * @param column A numeric column of the dataset stored as `T`
+		 * @returns The first value of the column
+		 */
+		template <typename T> T* numbers(const DataColumn& column) const {
+			return reinterpret_cast<T*>(numData + numOffsets[column.index]);
+		}
+
+		/**
+		 * Calls a function with the values of a numeric column in their storage type, so kernels over columns can be
+		 * written once for every storage type
+		 * 
+		 * @param column A numeric column of the dataset
+		 * @param fn The function to call with the first value of the column
+		 */
+		template <typename Fn> void visitNumbers(const DataColumn& column, const Fn& fn) const {
+			switch (column.storage) {
+				case NumberStorage::float64: fn(numbers<const double>(column)); break;
+				case NumberStorage::float32: fn(numbers<const float>(column)); break;
+				case NumberStorage::int32: fn(numbers<const int32_t>(column)); break;
+				case NumberStorage::int16: fn(numbers<const int16_t>(column)); break;
+				case NumberStorage::int8: fn(numbers<const int8_t>(column)); break;
+			}
+		}
+
+		/**
+		 * Stores every numeric column in the narrowest type which holds all of its values exactly, once a load has parsed
+		 * all of its rows as doubles
+		 * 
+		 * @throws A string with a description of why the process failed
+		 */
+		void narrowNumericColumns();
+
+		/**
+		 * Stores the numeric columns in wider types, copying the rows already in the dataset
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param storages The storage type of each numeric column, which must hold every value of its current type exactly
+		 */
+		void widenNumericColumns(const std::vector<NumberStorage>& storages);
+
+		/**
+		 * Stores rows parsed into a staging block in the numeric columns, widening only the columns whose new values do
+		 * not fit their storage type
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param staged The staging block, with `rows` doubles per numeric column
+		 * @param firstRow The row the staged rows are stored from (the rows before it are already in the columns)
+		 * @param rows The amount of staged rows
+		 */
+		void storeStagedRows(const double* staged, size_t firstRow, size_t rows);
 
 		/**
 		 * Returns a column
@@ -310,26 +763,25 @@ namespace DataMiner {
 		DataColumn& getColumn(size_t column);
 
 		/**
-		 * Returns numeric data from the dataset
+		 * Creates a dataset without any rows, reading its columns from the start of csv data
 		 * 
 		 * @throws A string with a description of why the process failed
-		 * @param column The column name
-		 * @param row The row number
-		 * @returns The data
+		 * @param cursor The first byte of the csv data, advanced past the header row if there is one
+		 * @param end One past the last byte of the csv data
 		 */
-		double& getNumber(size_t column, size_t row);
+		Data(const char*& cursor, const char* end);
 
 		/**
-		 * Returns string data from the dataset
+		 * Checks whether a file holds csv data, either plain (`.csv`), compressed (`.csv.gz`, `.csv.zst`) or through a
+		 * pipe (which is assumed to carry csv data)
 		 * 
-		 * @throws A string with a description of why the process failed
-		 * @param column The column name
-		 * @param row The row number
-		 * @returns The data
+		 * @param filename The name of the file
+		 * @returns Whether or not the file holds csv data
 		 */
-		std::string& getString(size_t column, size_t row);
+		static bool isCsvFile(const std::string& filename);
 
 		friend struct DataRow;
+		friend class DataStream;
 
 	public:
 		/**
@@ -378,7 +830,7 @@ namespace DataMiner {
 		 * @param row The row number
 		 * @returns The data
 		 */
-		const double& getNumber(const char* column, size_t row) const;
+		double getNumber(const char* column, size_t row) const;
 
 		/**
 		 * Returns string data from the dataset
@@ -388,7 +840,7 @@ namespace DataMiner {
 		 * @param row The row number
 		 * @returns The data
 		 */
-		const std::string& getString(const char* column, size_t row) const;
+		std::string_view getString(const char* column, size_t row) const;
 
 		/**
 		 * Returns a column
@@ -407,7 +859,7 @@ namespace DataMiner {
 		 * @param row The row number
 		 * @returns The data
 		 */
-		const double& getNumber(size_t column, size_t row) const;
+		double getNumber(size_t column, size_t row) const;
 
 		/**
 		 * Returns string data from the dataset
@@ -417,7 +869,134 @@ namespace DataMiner {
 		 * @param row The row number
 		 * @returns The data
 		 */
-		const std::string& getString(size_t column, size_t row) const;
+		std::string_view getString(size_t column, size_t row) const;
+
+		/**
+		 * Returns the dictionary code of string data from the dataset (dictionary encoded columns only)
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param column The column number
+		 * @param row The row number
+		 * @returns The dictionary code of the data
+		 */
+		uint32_t getCode(size_t column, size_t row) const;
+
+		/**
+		 * Returns the dictionary codes of a dictionary encoded string column, so kernels can work on the codes directly
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param column The column number
+		 * @returns The code of the first row, followed by the other rows in order
+		 */
+		const uint32_t* getCodes(size_t column) const;
+
+		/**
+		 * Returns the dictionary of a dictionary encoded string column, which maps the column's strings to codes and back
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param column The column number
+		 * @returns The dictionary of the column
+		 */
+		const StringDictionary& getDictionary(size_t column) const;
+
+		/**
+		 * Adds the rows of another csv file (or pipe, or compressed file) to the dataset, the file must have the same
+		 * columns as the dataset (and a matching header row if the dataset's file had one)
+		 * 
+		 * Statistics, sorted row indexes and quantile bins are updated with the new rows instead of being rebuilt
+		 * 
+		 * Numeric columns keep their narrowed storage types, only a column whose new values do not fit its type is widened
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param filename The name of the csv file
+		 * @returns The amount of rows added
+		 */
+		size_t appendCsv(const char* filename);
+
+		/**
+		 * Adds the rows written to the end of the dataset's own csv file since it was loaded (or last followed), so a
+		 * growing file can be followed without loading it again
+		 * 
+		 * Only complete lines are read, a row still being written is picked up by a later call
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @returns The amount of rows added
+		 */
+		size_t appendNewRows();
+
+		/**
+		 * Sorts the rows of the dataset by every numeric feature column (in parallel across columns), so split searches
+		 * can scan the rows in order instead of sorting them again
+		 * 
+		 * @throws A string with a description of why the process failed
+		 */
+		void sortNumericColumns();
+
+		/**
+		 * Returns the rows of the dataset ordered by the values of a numeric column, rows with missing values come last
+		 * (`sortNumericColumns` must have been called)
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param column The column number
+		 * @returns The row numbers in order
+		 */
+		const std::vector<uint32_t>& getSortedRows(size_t column) const;
+
+		/**
+		 * Returns the values of a numeric column in its storage type, so kernels can work on the narrow values directly
+		 * (missing values are marked as described by `NumberStorage`)
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param column The column number
+		 * @returns The first value of the column, followed by the other rows in order
+		 */
+		template <typename T> const T* getNumbers(size_t column) const {
+			const DataColumn& col = getColumn(column);
+			if (col.type != DataType::number)
+				throw "Column is not a numeric column";
+			if (!col.stored)
+				throw "Column was excluded when the dataset was loaded";
+			if (col.storage != numberStorageOf<T>())
+				throw "Column is not stored as the requested type";
+			return numbers<const T>(col);
+		}
+
+		/**
+		 * The bin given to rows with missing values
+		 */
+		static constexpr uint8_t missingBin = 255;
+
+		/**
+		 * Quantizes every numeric feature column (in parallel across columns) into quantile bins of roughly equal row
+		 * counts, so split searches can build small histograms of bins instead of scanning raw values
+		 * 
+		 * Appended rows are binned with the existing edges (the last edge grows to fit larger values), call this again to
+		 * rebalance the bins once many rows have been appended
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param maxBins The most bins per column, at most 255 (columns with fewer distinct values get one bin per value)
+		 */
+		void binNumericColumns(size_t maxBins = 255);
+
+		/**
+		 * Returns the quantile bin of every row for a numeric column, rows with missing values are in `missingBin`
+		 * (`binNumericColumns` must have been called)
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param column The column number
+		 * @returns The bin of each row
+		 */
+		const std::vector<uint8_t>& getBins(size_t column) const;
+
+		/**
+		 * Returns the largest value in each quantile bin of a numeric column, a row is in the first bin whose edge is not
+		 * less than its value (`binNumericColumns` must have been called)
+		 * 
+		 * @throws A string with a description of why the process failed
+		 * @param column The column number
+		 * @returns The edge of each bin
+		 */
+		const std::vector<double>& getBinEdges(size_t column) const;
 
 		/**
 		 * Sets the target of the dataset to a column
@@ -0,0 +1,497 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "Data.hpp"
+
+using namespace DataMiner;
+
+#include <Logger/Logger.hpp>
+#include <Data/ColumnAllocator.hpp>
+#include <Data/MappedFile.hpp>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+/*
+ * Layout of a cache file (all values in native byte order):
+ *
+ *   magic, csv size, csv modification time, row count, column count, header flag
+ *   for every column: type, role, encoding, number storage, name length, name, min, max, null count, distinct count
+ *   stored numeric columns, one after the other (in their storage types, 64 byte aligned, each padded to the padded
+ *   row count)
+ *   dictionary codes of the stored dictionary encoded columns, one after the other (uint32s, laid out the same way)
+ *   for every dictionary: value count, byte count, value offsets, characters
+ *   for every arena: string count, byte count, string offsets, characters
+ *   distinct value sketches of the stored numeric columns and then the arena columns
+ */
+
+/**
+ * Marks a file as a dataset cache, and the version of its layout
+ */
+static const char cacheMagic[8] = {'D', 'M', 'C', 'A', 'C', 'H', 'E', '5'};
+
+/**
+ * Alignment of the column blocks within a cache file
+ */
+static const size_t cacheAlignment = 64;
+
+/**
+ * Helper function to get the name of the cache file of a csv file
+ *
+ * @param filename The name of the csv file
+ * @returns The name of the cache file
+ */
+static std::string cachePath(const char* filename) {
+	return std::string(filename) + ".dmcache";
+}
+
+/**
+ * Helper function to get the modification time of a file as a plain number
+ *
+ * @param filename The name of the file
+ * @returns The modification time
+ */
+static int64_t modificationTime(const std::string& filename) {
+	return static_cast<int64_t>(std::filesystem::last_write_time(filename).time_since_epoch().count());
+}
+
+/**
+ * Writes the sections of a cache file
+ */
+class CacheWriter {
+private:
+
+	/**
+	 * The file being written
+	 */
+	std::ofstream out;
+
+	/**
+	 * The amount of bytes written so far
+	 */
+	size_t written;
+
+public:
+
+	/**
+	 * Creates the file
+	 *
+	 * @throws A string with a description of why the process failed
+	 * @param filename The name of the file
+	 */
+	CacheWriter(const std::string& filename) : out(filename, std::ios::binary | std::ios::trunc), written(0) {
+		if (!out.is_open())
+			throw "Unable to create the dataset cache file";
+	}
+
+	/**
+	 * Writes raw bytes
+	 *
+	 * @param data The bytes
+	 * @param size The amount of bytes
+	 */
+	void write(const void* data, size_t size) {
+		out.write(static_cast<const char*>(data), size);
+		written += size;
+	}
+
+	/**
+	 * Writes a single value
+	 *
+	 * @param value The value
+	 */
+	template <typename T> void write(T value) {
+		write(&value, sizeof(T));
+	}
+
+	/**
+	 * Writes zeros
+	 *
+	 * @param size The amount of zeros
+	 */
+	void pad(size_t size) {
+		static const char zeros[cacheAlignment] = {};
+		for (; size > cacheAlignment; size -= cacheAlignment)
+			write(zeros, cacheAlignment);
+		write(zeros, size);
+	}
+
+	/**
+	 * Pads the file with zeros up to the next multiple of the cache alignment
+	 */
+	void align() {
+		pad((cacheAlignment - written % cacheAlignment) % cacheAlignment);
+	}
+
+	/**
+	 * Writes the values of a list of strings (a count, a byte count, the offsets and then the characters)
+	 *
+	 * @param count The amount of strings
+	 * @param get Returns a string given its index
+	 */
+	template <typename Get> void writeStrings(size_t count, const Get& get) {
+		uint64_t bytes = 0;
+		for (size_t i = 0; i < count; i++)
+			bytes += get(i).size();
+		write<uint64_t>(count);
+		write<uint64_t>(bytes);
+
+		uint64_t offset = 0;
+		write<uint64_t>(offset);
+		for (size_t i = 0; i < count; i++) {
+			offset += get(i).size();
+			write<uint64_t>(offset);
+		}
+		for (size_t i = 0; i < count; i++) {
+			std::string_view value = get(i);
+			write(value.data(), value.size());
+		}
+	}
+
+	/**
+	 * Flushes and closes the file
+	 *
+	 * @throws A string with a description of why the process failed
+	 */
+	void close() {
+		out.close();
+		if (out.fail())
+			throw "Unable to write the dataset cache file";
+	}
+};
+
+/**
+ * Reads the sections of a mapped cache file, checking every read against the end of the file
+ */
+class CacheReader {
+private:
+
+	/**
+	 * The first byte of the file
+	 */
+	const char* begin;
+
+	/**
+	 * The next unread byte
+	 */
+	const char* cursor;
+
+	/**
+	 * One past the last byte of the file
+	 */
+	const char* end;
+
+public:
+
+	/**
+	 * Creates a reader at the start of a mapped file
+	 *
+	 * @param file The file
+	 */
+	CacheReader(const MappedFile& file) : begin(file.begin()), cursor(file.begin()), end(file.end()) {}
+
+	/**
+	 * Reads raw bytes
+	 *
+	 * @throws A string if the file ends before the bytes
+	 * @param size The amount of bytes
+	 * @returns The first of the bytes, within the mapped file
+	 */
+	const char* read(size_t size) {
+		if (static_cast<size_t>(end - cursor) < size)
+			throw "The dataset cache file is truncated";
+		const char* data = cursor;
+		cursor += size;
+		return data;
+	}
+
+	/**
+	 * Reads a single value
+	 *
+	 * @throws A string if the file ends before the value
+	 * @returns The value
+	 */
+	template <typename T> T read() {
+		T value;
+		std::memcpy(&value, read(sizeof(T)), sizeof(T));
+		return value;
+	}
+
+	/**
+	 * Skips the padding up to the next multiple of the cache alignment
+	 *
+	 * @throws A string if the file ends before the padding
+	 */
+	void align() {
+		read((cacheAlignment - (cursor - begin) % cacheAlignment) % cacheAlignment);
+	}
+
+	/**
+	 * Reads the values of a list of strings written by `CacheWriter::writeStrings`
+	 *
+	 * @throws A string if the file is truncated or the offsets are out of range
+	 * @param add Called with every string in order
+	 */
+	template <typename Add> void readStrings(const Add& add) {
+		uint64_t count = read<uint64_t>();
+		uint64_t bytes = read<uint64_t>();
+		if (count > static_cast<size_t>(end - cursor) / sizeof(uint64_t))
+			throw "The dataset cache file is truncated";
+		const char* offsets = read((count + 1) * sizeof(uint64_t));
+		const char* chars = read(bytes);
+
+		uint64_t previous = 0;
+		for (size_t i = 0; i < count; i++) {
+			uint64_t next;
+			std::memcpy(&next, offsets + (i + 1) * sizeof(uint64_t), sizeof(uint64_t));
+			if (next < previous || next > bytes)
+				throw "The dataset cache file is corrupt";
+			add(std::string_view(chars + previous, next - previous));
+			previous = next;
+		}
+	}
+};
+
+/**
+ * Writes the parsed dataset to a binary cache file next to the csv file, so later loads can skip parsing
+ *
+ * The cache is written to a temporary file first and then renamed, so a crash never leaves a partial cache behind
+ *
+ * @throws A string with a description of why the process failed
+ * @param filename The name of the csv file
+ */
+void DataMiner::Data::saveCache(const char* filename) const {
+	std::string path = cachePath(filename);
+	std::string temporary = path + ".tmp";
+	std::error_code error;
+
+	try {
+		CacheWriter writer(temporary);
+		writer.write(cacheMagic, sizeof(cacheMagic));
+		writer.write<uint64_t>(std::filesystem::file_size(filename));
+		writer.write<int64_t>(modificationTime(filename));
+		writer.write<uint64_t>(nrows);
+		writer.write<uint64_t>(ncols);
+		writer.write<uint8_t>(hasHeader);
+
+		size_t dictionaryColumns = 0;
+		for (const DataColumn& col : cols) {
+			writer.write<uint8_t>(static_cast<uint8_t>(col.type));
+			writer.write<uint8_t>(static_cast<uint8_t>(col.role));
+			writer.write<uint8_t>(static_cast<uint8_t>(col.encoding));
+			writer.write<uint8_t>(static_cast<uint8_t>(col.storage));
+			writer.write<uint64_t>(col.name.size());
+			writer.write(col.name.data(), col.name.size());
+			writer.write<double>(col.min);
+			writer.write<double>(col.max);
+			writer.write<uint64_t>(col.nullCount);
+			writer.write<uint64_t>(col.distinctCount);
+			if (col.stored && col.type == DataType::string && col.encoding == StringEncoding::dictionary)
+				dictionaryColumns++;
+		}
+
+		// Columns keep their padding so the mapped buffers have the same aligned layout as allocated ones
+		size_t paddedRows = ColumnAllocator::paddedRows(nrows);
+		writer.align();
+		for (const DataColumn& col : cols) {
+			if (!col.stored || col.type != DataType::number)
+				continue;
+			size_t size = numberStorageSize(col.storage);
+			writer.write(numData + numOffsets[col.index], nrows * size);
+			writer.pad((paddedRows - nrows) * size);
+		}
+		writer.align();
+		for (size_t column = 0; column < dictionaryColumns; column++) {
+			writer.write(strCodes + column * rowCapacity, nrows * sizeof(uint32_t));
+			writer.pad((paddedRows - nrows) * sizeof(uint32_t));
+		}
+
+		for (const StringDictionary& dictionary : dictionaries)
+			writer.writeStrings(dictionary.size(), [&dictionary](size_t i) {
+				return std::string_view(dictionary.get(static_cast<uint32_t>(i)));
+			});
+		for (const StringArena& arena : arenas)
+			writer.writeStrings(arena.size(), [&arena](size_t i) {
+				return arena.get(i);
+			});
+		for (const HyperLogLog& sketch : numSketches)
+			writer.write(sketch.data(), HyperLogLog::size);
+		for (const HyperLogLog& sketch : arenaSketches)
+			writer.write(sketch.data(), HyperLogLog::size);
+		writer.close();
+	}
+	catch (const std::filesystem::filesystem_error&) {
+		std::filesystem::remove(temporary, error);
+		throw "Unable to read the size and modification time of the csv file";
+	}
+	catch (const char*) {
+		std::filesystem::remove(temporary, error);
+		throw;
+	}
+
+	std::filesystem::rename(temporary, path, error);
+	if (error) {
+		std::filesystem::remove(temporary, error);
+		throw "Unable to replace the dataset cache file";
+	}
+	logger->info("Saved a binary cache of the dataset");
+}
+
+/**
+ * Loads the dataset from the binary cache file of a csv file, mapping its column buffers directly
+ *
+ * The cache is only used if it was written for the csv file as it is now (same size and modification time)
+ *
+ * @throws A string with a description of why the process failed
+ * @param filename The name of the csv file
+ * @returns Whether or not an up to date cache was found and loaded
+ */
+bool DataMiner::Data::loadCache(const char* filename) {
+	std::string path = cachePath(filename);
+	std::error_code error;
+	if (!std::filesystem::is_regular_file(path, error))
+		return false;
+
+	uint64_t csvSize = std::filesystem::file_size(filename, error);
+	if (error)
+		return false;
+	int64_t csvTime = 0;
+	try {
+		csvTime = modificationTime(filename);
+	}
+	catch (const std::filesystem::filesystem_error&) {
+		return false;
+	}
+
+	MappedFile* mapped = new MappedFile(path.c_str());
+	try {
+		CacheReader reader(*mapped);
+		if (std::memcmp(reader.read(sizeof(cacheMagic)), cacheMagic, sizeof(cacheMagic)) != 0)
+			throw "The dataset cache file is not a valid cache";
+		if (reader.read<uint64_t>() != csvSize || reader.read<int64_t>() != csvTime) {
+			delete mapped;
+			logger->info("The dataset cache is out of date, parsing the csv file");
+			return false;
+		}
+
+		size_t rows = reader.read<uint64_t>();
+		size_t columns = reader.read<uint64_t>();
+		bool header = reader.read<uint8_t>() != 0;
+
+		std::vector<DataColumn> columnTypes;
+		size_t numColumns = 0;
+		size_t dictionaryColumns = 0;
+		size_t arenaColumns = 0;
+		for (size_t i = 0; i < columns; i++) {
+			uint8_t type = reader.read<uint8_t>();
+			uint8_t role = reader.read<uint8_t>();
+			uint8_t encoding = reader.read<uint8_t>();
+			uint8_t storage = reader.read<uint8_t>();
+			uint64_t nameLength = reader.read<uint64_t>();
+			std::string name(reader.read(nameLength), nameLength);
+			double min = reader.read<double>();
+			double max = reader.read<double>();
+			uint64_t nullCount = reader.read<uint64_t>();
+			uint64_t distinctCount = reader.read<uint64_t>();
+			if (type > static_cast<uint8_t>(DataType::string) || role > static_cast<uint8_t>(DataRole::excluded) ||
+				encoding > static_cast<uint8_t>(StringEncoding::arena) || storage > static_cast<uint8_t>(NumberStorage::int8))
+				throw "The dataset cache file is corrupt";
+
+			columnTypes.emplace_back(static_cast<DataType>(type), name.c_str(), static_cast<DataRole>(role));
+			columnTypes.back().encoding = static_cast<StringEncoding>(encoding);
+			columnTypes.back().storage = static_cast<NumberStorage>(storage);
+			columnTypes.back().min = min;
+			columnTypes.back().max = max;
+			columnTypes.back().nullCount = nullCount;
+			columnTypes.back().distinctCount = distinctCount;
+			if (columnTypes.back().role == DataRole::excluded)
+				continue;
+			if (columnTypes.back().type == DataType::number)
+				numColumns++;
+			else if (columnTypes.back().encoding == StringEncoding::dictionary)
+				dictionaryColumns++;
+			else
+				arenaColumns++;
+		}
+
+		if (rows > SIZE_MAX / 2)
+			throw "The dataset cache file is corrupt";
+		size_t paddedRows = ColumnAllocator::paddedRows(rows);
+		if (paddedRows != 0 && (numColumns > SIZE_MAX / sizeof(double) / paddedRows || dictionaryColumns > SIZE_MAX / sizeof(uint32_t) / paddedRows))
+			throw "The dataset cache file is corrupt";
+		reader.align();
+		std::vector<size_t> offsets;
+		size_t numBytes = 0;
+		for (const DataColumn& col : columnTypes) {
+			if (col.role == DataRole::excluded || col.type != DataType::number)
+				continue;
+			offsets.push_back(numBytes);
+			numBytes += paddedRows * numberStorageSize(col.storage);
+		}
+		const char* numBlock = reader.read(numBytes);
+		reader.align();
+		const char* codeBlock = reader.read(dictionaryColumns * paddedRows * sizeof(uint32_t));
+
+		std::vector<StringDictionary> columnDictionaries(dictionaryColumns);
+		for (StringDictionary& dictionary : columnDictionaries)
+			reader.readStrings([&dictionary](std::string_view value) {
+				dictionary.insert(value);
+			});
+		std::vector<StringArena> columnArenas(arenaColumns);
+		for (StringArena& arena : columnArenas) {
+			reader.readStrings([&arena](std::string_view value) {
+				arena.append(value);
+			});
+			if (arena.size() != rows)
+				throw "The dataset cache file is corrupt";
+		}
+		std::vector<HyperLogLog> columnNumSketches(numColumns);
+		for (HyperLogLog& sketch : columnNumSketches)
+			sketch.load(reinterpret_cast<const uint8_t*>(reader.read(HyperLogLog::size)));
+		std::vector<HyperLogLog> columnArenaSketches(arenaColumns);
+		for (HyperLogLog& sketch : columnArenaSketches)
+			sketch.load(reinterpret_cast<const uint8_t*>(reader.read(HyperLogLog::size)));
+
+		// Every code has to refer to a value of its column's dictionary
+		for (size_t column = 0; column < dictionaryColumns; column++) {
+			const uint32_t* codes = reinterpret_cast<const uint32_t*>(codeBlock) + column * paddedRows;
+			for (size_t row = 0; row < rows; row++)
+				if (codes[row] >= columnDictionaries[column].size())
+					throw "The dataset cache file is corrupt";
+		}
+
+		freeBuffers();
+		cache = mapped;
+		numData = const_cast<char*>(numBlock);
+		numOffsets = std::move(offsets);
+		strCodes = const_cast<uint32_t*>(reinterpret_cast<const uint32_t*>(codeBlock));
+		cols = std::move(columnTypes);
+		dictionaries = std::move(columnDictionaries);
+		arenas = std::move(columnArenas);
+		numSketches = std::move(columnNumSketches);
+		arenaSketches = std::move(columnArenaSketches);
+		nrows = rows;
+		rowCapacity = paddedRows;
+		ncols = columns;
+		hasHeader = header;
+		indexColumns();
+	}
+	catch (const char*) {
+		delete mapped;
+		throw;
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "DataStream.hpp"
+#include <Data/CompressedFile.hpp>
+#include <Data/CsvScanner.hpp>
+#include <Logger/Logger.hpp>
+#include <filesystem>
+
+using namespace DataMiner;
+
+/**
+ * Opens a dataset for streaming, asking the user for the file and column roles
+ *
+ * @throws A string with a description of why the process failed
+ * @param batchBytes Approximate amount of csv text read per batch
+ */
+DataMiner::DataStream::DataStream(size_t batchBytes) : file(nullptr), batch(nullptr), batchBytes(batchBytes), firstRow(0) {
+	std::string filename = logger->getInput<std::string>("Please input the file name of the dataset (csv)", [](const std::string& value) {
+		// Batches are cut straight out of the mapped file and the stream can be rewound, so compressed files and
+		// pipes (which `Data` decompresses or reads as they arrive) can not be streamed
+		std::error_code error;
+		return Data::isCsvFile(value) && !CompressedFile::isCompressed(value) && std::filesystem::is_regular_file(value, error) && std::ifstream(value).is_open();
+	});
+
+	file = new MappedFile(filename.c_str());
+	cursor = file->begin();
+
+	try {
+		batch = new Data(cursor, file->end());
+		batch->chooseStringEncodings(cursor, file->end());
+	}
+	catch (const char* error) {
+		delete file;
+		throw error;
+	}
+	body = cursor;
+}
+
+/**
+ * Frees resources
+ */
+DataMiner::DataStream::~DataStream() {
+	delete batch;
+	delete file;
+}
+
+/**
+ * Loads the next batch of rows, replacing the current one
+ *
+ * @throws A string with a description of why the process failed
+ * @returns Whether or not there was another batch
+ */
+bool DataMiner::DataStream::nextBatch() {
+	if (cursor >= file->end())
+		return false;
+
+	// Cut the batch at the first row boundary after the byte budget (the quotes before the cut tell whether it is
+	// inside of a quoted field)
+	const char* end = file->end();
+	if (static_cast<size_t>(end - cursor) > batchBytes) {
+		const char* split = cursor + batchBytes;
+		end = CsvScanner::nextRowStart(split, end, CsvScanner::countQuotes(cursor, split) % 2 == 1);
+	}
+
+	firstRow += batch->numRows();
+	batch->loadCsvRows(cursor, end);
+
+	// The batch has been copied out of the file, so its pages are not needed anymore
+	file->release(cursor, end);
+	cursor = end;
+	return true;
+}
+
+/**
+ * Starts the stream over from the first row
+ */
+void DataMiner::DataStream::rewind() {
+	cursor = body;
+	firstRow = 0;
+	batch->loadCsvRows(cursor, cursor);
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <Data/Data.hpp>
+#include <Data/MappedFile.hpp>
+
+/**
+ * Main data mining namespace
+ */
+namespace DataMiner {
+
+	/**
+	 * Reads a dataset which may not fit into memory one batch of rows at a time
+	 *
+	 * Every batch is loaded into the same `Data` object (with the same column-major layout as a fully loaded
+	 * dataset), so columns retrieved from it stay valid for the whole stream
+	 */
+	class DataStream {
+	private:
+
+		/**
+		 * The file storing the dataset
+		 */
+		MappedFile* file;
+
+		/**
+		 * The dataset holding the current batch
+		 */
+		Data* batch;
+
+		/**
+		 * The first row of the file after the header
+		 */
+		const char* body;
+
+		/**
+		 * The first row of the next batch
+		 */
+		const char* cursor;
+
+		/**
+		 * Approximate amount of csv text read per batch
+		 */
+		size_t batchBytes;
+
+		/**
+		 * The index of the first row of the current batch within the whole dataset
+		 */
+		size_t firstRow;
+
+	public:
+
+		/**
+		 * Default approximate amount of csv text read per batch
+		 */
+		static const size_t defaultBatchBytes = 64 << 20;
+
+		/**
+		 * Opens a dataset for streaming, asking the user for the file and column roles
+		 *
+		 * @throws A string with a description of why the process failed
+		 * @param batchBytes Approximate amount of csv text read per batch
+		 */
+		DataStream(size_t batchBytes = defaultBatchBytes);
+
+		/**
+		 * Frees resources
+		 */
+		~DataStream();
+
+		DataStream(const DataStream&) = delete;
+		DataStream& operator=(const DataStream&) = delete;
+
+		/**
+		 * Loads the next batch of rows, replacing the current one
+		 *
+		 * @throws A string with a description of why the process failed
+		 * @returns Whether or not there was another batch
+		 */
+		bool nextBatch();
+
+		/**
+		 * Starts the stream over from the first row
+		 */
+		void rewind();
+
+		/**
+		 * Returns the dataset holding the current batch (without any rows before the first batch is loaded)
+		 *
+		 * @returns The dataset holding the current batch
+		 */
+		const Data& getBatch() const {
+			return *batch;
+		}
+
+		/**
+		 * Returns the index of the first row of the current batch within the whole dataset
+		 *
+		 * @returns The index of the first row of the current batch
+		 */
+		size_t batchFirstRow() const {
+			return firstRow;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "HyperLogLog.hpp"
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+using namespace DataMiner;
+
+/**
+ * Helper function to spread the bits of a hash evenly (the splitmix64 finalizer), since the registers are picked by
+ * the top bits of the hash
+ *
+ * @param value The value to mix
+ * @returns The mixed value
+ */
+static uint64_t mix(uint64_t value) {
+	value += 0x9e3779b97f4a7c15ull;
+	value ^= value >> 30;
+	value *= 0xbf58476d1ce4e5b9ull;
+	value ^= value >> 27;
+	value *= 0x94d049bb133111ebull;
+	value ^= value >> 31;
+	return value;
+}
+
+/**
+ * Adds all values of another sketch to this one
+ *
+ * @param other The other sketch
+ */
+void DataMiner::HyperLogLog::merge(const HyperLogLog& other) {
+	for (size_t i = 0; i < size; i++)
+		if (other.registers[i] > registers[i])
+			registers[i] = other.registers[i];
+}
+
+/**
+ * Estimates the amount of distinct values added to the sketch
+ *
+ * @returns The estimated amount of distinct values
+ */
+size_t DataMiner::HyperLogLog::estimate() const {
+	double sum = 0;
+	size_t zeros = 0;
+	for (uint8_t reg : registers) {
+		sum += std::ldexp(1.0, -static_cast<int>(reg));
+		if (reg == 0)
+			zeros++;
+	}
+
+	double m = static_cast<double>(size);
+	double estimate = 0.7213 / (1.0 + 1.079 / m) * m * m / sum;
+
+	// Small counts leave many registers empty, where counting the empty registers is far more accurate
+	if (estimate <= 2.5 * m && zeros != 0)
+		estimate = m * std::log(m / static_cast<double>(zeros));
+	return static_cast<size_t>(std::llround(estimate));
+}
+
+/**
+ * Hashes a string for the sketch
+ *
+ * @param value The string
+ * @returns The hash
+ */
+uint64_t DataMiner::HyperLogLog::hash(std::string_view value) {
+	return mix(static_cast<uint64_t>(std::hash<std::string_view>()(value)));
+}
+
+/**
+ * Hashes a number for the sketch
+ *
+ * @param value The number
+ * @returns The hash
+ */
+uint64_t DataMiner::HyperLogLog::hash(double value) {
+	// 0 and -0 are the same value
+	if (value == 0)
+		value = 0;
+	uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return mix(bits);
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace DataMiner;
+
+/**
+ * Maps a file into memory
+ *
+ * @throws A string with a description of why the process failed
+ * @param filename The name of the file to map
+ */
+DataMiner::MappedFile::MappedFile(const char* filename) : data(nullptr), length(0) {
+#ifdef _WIN32
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		throw "Unable to Open File Error";
+
+	length = static_cast<size_t>(file.tellg());
+	if (length == 0)
+		return;
+
+	char* buffer = new char[length];
+	file.seekg(0, std::ios::beg);
+	if (!file.read(buffer, length)) {
+		delete[] buffer;
+		throw "Unable to read file into memory";
+	}
+	data = buffer;
+#else
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0)
+		throw "Unable to Open File Error";
+
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+		close(fd);
+		throw "Unable to read file size";
+	}
+
+	length = static_cast<size_t>(info.st_size);
+	if (length == 0) {
+		close(fd);
+		return;
+	}
+
+	void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+		throw "Unable to map file into memory";
+
+	// The loader walks the file front to back, let the kernel read ahead aggressively
+	madvise(mapping, length, MADV_SEQUENTIAL);
+	data = static_cast<const char*>(mapping);
+#endif
+}
+
+/**
+ * Unmaps the file
+ */
+DataMiner::MappedFile::~MappedFile() {
+	if (data == nullptr)
+		return;
+#ifdef _WIN32
+	delete[] data;
+#else
+	munmap(const_cast<char*>(data), length);
+#endif
+}
+
+/**
+ * Tells the operating system a range of the file will not be read again, so its pages can be dropped from memory
+ *
+ * @param begin The first byte of the range
+ * @param end One past the last byte of the range
+ */
+void DataMiner::MappedFile::release(const char* begin, const char* end) {
+#ifndef _WIN32
+	// Only whole pages inside of the range can be dropped
+	size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t first = (static_cast<size_t>(begin - data) + pageSize - 1) / pageSize * pageSize;
+	size_t last = static_cast<size_t>(end - data) / pageSize * pageSize;
+	if (first < last)
+		madvise(const_cast<char*>(data) + first, last - first, MADV_DONTNEED);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Main data mining namespace
+ */
+namespace DataMiner {
+
+	/**
+	 * A read only view of an entire file mapped into memory
+	 *
+	 * On platforms without mmap the file is read into a single heap buffer instead
+	 */
+	class MappedFile {
+	private:
+
+		/**
+		 * The first byte of the mapped file
+		 */
+		const char* data;
+
+		/**
+		 * The amount of bytes in the mapped file
+		 */
+		size_t length;
+
+	public:
+
+		/**
+		 * Maps a file into memory
+		 *
+		 * @throws A string with a description of why the process failed
+		 * @param filename The name of the file to map
+		 */
+		MappedFile(const char* filename);
+
+		/**
+		 * Unmaps the file
+		 */
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/**
+		 * Tells the operating system a range of the file will not be read again, so its pages can be dropped from memory
+		 *
+		 * @param begin The first byte of the range
+		 * @param end One past the last byte of the range
+		 */
+		void release(const char* begin, const char* end);
+
+		/**
+		 * Returns the first byte of the file
+		 *
+		 * @returns The first byte of the file
+		 */
+		const char* begin() const {
+			return data;
+		}
+
+		/**
+		 * Returns one past the last byte of the file
+		 *
+		 * @returns One past the last byte of the file
+		 */
+		const char* end() const {
+			return data + length;
+		}
+
+		/**
+		 * Returns the size of the file in bytes
+		 *
+		 * @returns The size of the file in bytes
+		 */
+		size_t size() const {
+			return length;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "Number.hpp"
+#include <charconv>
+
+using namespace DataMiner;
+
+/**
+ * Parses a number out of a slice of text without allocating, throwing, or consulting the locale
+ *
+ * The whole slice must be a number, optionally with a leading sign (ie "-1.5", "+2", "3e-4")
+ *
+ * @param text The text to parse
+ * @param value Set to the parsed number if the text was valid
+ * @returns Whether or not the text was a valid number
+ */
+bool DataMiner::parseNumber(std::string_view text, double& value) {
+	// from_chars only accepts a leading minus sign
+	if (!text.empty() && text.front() == '+')
+		text.remove_prefix(1);
+	if (text.empty())
+		return false;
+
+	const char* end = text.data() + text.size();
+	std::from_chars_result result = std::from_chars(text.data(), end, value);
+	return result.ec == std::errc() && result.ptr == end;
+}
+
+/**
+ * Checks if a slice of text is a valid number written with digits
+ *
+ * Spellings such as "nan" and "inf" are parsed as numbers but are not accepted here, so a string column holding words
+ * like "Nan" or "Inf" is never mistaken for a numeric one
+ *
+ * @param text The text to check
+ * @returns Whether or not the text is a valid number
+ */
+bool DataMiner::isNumber(std::string_view text) {
+	std::string_view digits = text;
+	if (!digits.empty() && (digits.front() == '-' || digits.front() == '+'))
+		digits.remove_prefix(1);
+	if (digits.empty() || (digits.front() != '.' && (digits.front() < '0' || digits.front() > '9')))
+		return false;
+
+	double value;
+	return parseNumber(text, value);
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <string_view>
+
+/**
+ * Main data mining namespace
+ */
+namespace DataMiner {
+
+	/**
+	 * Parses a number out of a slice of text without allocating, throwing, or consulting the locale
+	 *
+	 * The whole slice must be a number, optionally with a leading sign (ie "-1.5", "+2", "3e-4")
+	 *
+	 * @param text The text to parse
+	 * @param value Set to the parsed number if the text was valid
+	 * @returns Whether or not the text was a valid number
+	 */
+	bool parseNumber(std::string_view text, double& value);
+
+	/**
+	 * Checks if a slice of text is a valid number written with digits (not "nan" or "inf")
+	 *
+	 * @param text The text to check
+	 * @returns Whether or not the text is a valid number
+	 */
+	bool isNumber(std::string_view text);
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "RowSampler.hpp"
+
+#include <Data/CsvScanner.hpp>
+#include <algorithm>
+#include <limits>
+
+using namespace DataMiner;
+
+/**
+ * Seed of the sampling random number generator
+ */
+static const uint64_t sampleSeed = 0x5eed5a3b1e5ull;
+
+/**
+ * Size of the slices rows are split into
+ */
+static const size_t sliceSize = 1 << 20;
+
+/**
+ * Creates an empty sample
+ *
+ * @throws A string with a description of why the process failed
+ * @param capacity The most rows to keep
+ * @param column The position of the column to stratify the sample by, the maximum size_t for a uniform sample
+ */
+DataMiner::RowSampler::RowSampler(size_t capacity, size_t column) : capacity(capacity), column(column), seen(0), random(sampleSeed) {
+	if (capacity == 0)
+		throw "A sample has to keep at least one row";
+	if (column == std::numeric_limits<size_t>::max())
+		strata.push_back({0, {}});
+}
+
+/**
+ * Offers every row of a block of csv data to the sample
+ *
+ * @param begin The first byte of the block (must be the start of a row)
+ * @param end One past the last byte of the block (must be the end of a row)
+ */
+void DataMiner::RowSampler::addRows(const char* begin, const char* end) {
+	// Rows are split a slice at a time so the row ends of a whole file are never held at once
+	while (begin < end) {
+		const char* sliceEnd = end;
+		if (static_cast<size_t>(end - begin) > sliceSize) {
+			sliceEnd = CsvScanner::lastRowEnd(begin, begin + sliceSize);
+			// A single row longer than a slice is a slice of its own
+			if (sliceEnd == begin)
+				sliceEnd = CsvScanner::nextRowStart(begin, end, false);
+		}
+
+		rowEnds.clear();
+		CsvScanner::findRowEnds(begin, sliceEnd, rowEnds);
+		const char* rowBegin = begin;
+		for (const char* rowEnd : rowEnds) {
+			Stratum& stratum = column == std::numeric_limits<size_t>::max() ? strata[0] : stratumOf(rowBegin, rowEnd);
+			offer(stratum, rowBegin, rowEnd);
+			seen++;
+			rowBegin = rowEnd;
+		}
+		begin = sliceEnd;
+	}
+}
+
+/**
+ * Returns the stratum a row belongs to, adding a stratum (and shrinking the others to make room) for new values
+ *
+ * @param begin The first byte of the row
+ * @param end One past the last byte of the row
+ * @returns The stratum
+ */
+RowSampler::Stratum& DataMiner::RowSampler::stratumOf(const char* begin, const char* end) {
+	// Rows which are too short are missing the value, which is then empty
+	CsvScanner scanner(begin, end);
+	std::string_view value;
+	bool lastInRow = false;
+	size_t i = 0;
+	while (scanner.nextField(value, lastInRow) && i < column && !lastInRow)
+		i++;
+	if (i != column)
+		value = std::string_view();
+
+	auto found = strataIndex.find(std::string(value));
+	if (found != strataIndex.end())
+		return strata[found->second];
+
+	// Every stratum keeps its share, a random subset of a uniform sample is still a uniform sample
+	strataIndex.emplace(std::string(value), strata.size());
+	strata.push_back({0, {}});
+	for (size_t i = 0; i < strata.size(); i++) {
+		Stratum& stratum = strata[i];
+		size_t share = shareOf(i);
+		if (stratum.rows.size() <= share)
+			continue;
+		std::shuffle(stratum.rows.begin(), stratum.rows.end(), random);
+		stratum.rows.resize(share);
+	}
+	return strata.back();
+}
+
+/**
+ * Returns the most rows a stratum keeps, the capacity is split evenly with the remainder going to the first strata (so
+ * strata after the first `capacity` keep none when there are more strata than rows)
+ *
+ * @param stratum The position of the stratum
+ * @returns The amount of rows
+ */
+size_t DataMiner::RowSampler::shareOf(size_t stratum) const {
+	return capacity / strata.size() + (stratum < capacity % strata.size() ? 1 : 0);
+}
+
+/**
+ * Offers a row to a stratum, keeping it with the probability which keeps the stratum a uniform sample
+ *
+ * @param stratum The stratum
+ * @param begin The first byte of the row
+ * @param end One past the last byte of the row
+ */
+void DataMiner::RowSampler::offer(Stratum& stratum, const char* begin, const char* end) {
+	size_t share = shareOf(&stratum - strata.data());
+	stratum.seen++;
+	if (stratum.rows.size() < share) {
+		stratum.rows.push_back({seen, std::string(begin, end)});
+		if (stratum.rows.back().bytes.empty() || stratum.rows.back().bytes.back() != '\n')
+			stratum.rows.back().bytes.push_back('\n');
+		return;
+	}
+
+	size_t slot = std::uniform_int_distribution<size_t>(0, stratum.seen - 1)(random);
+	if (slot >= share)
+		return;
+	SampledRow& row = stratum.rows[slot];
+	row.number = seen;
+	row.bytes.assign(begin, end);
+	if (row.bytes.empty() || row.bytes.back() != '\n')
+		row.bytes.push_back('\n');
+}
+
+/**
+ * Hands out the sampled rows as csv data, in the order they were offered
+ *
+ * @returns The rows, each ending with a newline
+ */
+std::string DataMiner::RowSampler::takeSample() {
+	std::vector<SampledRow> rows;
+	for (Stratum& stratum : strata)
+		for (SampledRow& row : stratum.rows)
+			rows.push_back(std::move(row));
+	strata.clear();
+	strataIndex.clear();
+	std::sort(rows.begin(), rows.end(), [](const SampledRow& a, const SampledRow& b) {
+		return a.number < b.number;
+	});
+
+	std::string sample;
+	for (const SampledRow& row : rows)
+		sample += row.bytes;
+	return sample;
+}
\ No newline at end of file
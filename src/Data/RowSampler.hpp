@@ -0,0 +1,169 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Main data mining namespace
+ */
+namespace DataMiner {
+
+	/**
+	 * Keeps a fixed size random sample of the rows of csv data while it streams past
+	 *
+	 * Rows are only split apart at their newlines, the rows left out of the sample are never parsed into fields. The
+	 * sample is either uniform (a reservoir over every row) or stratified by a column, where every distinct value of
+	 * the column keeps an equal share of the sample (values with fewer rows than their share keep all of them, and the
+	 * sample never grows past its size even when there are more values than rows)
+	 */
+	class RowSampler {
+	private:
+
+		/**
+		 * A row kept in the sample
+		 */
+		struct SampledRow {
+			/**
+			 * The position of the row among every row offered to the sampler
+			 */
+			size_t number;
+
+			/**
+			 * The bytes of the row, ending with a newline
+			 */
+			std::string bytes;
+		};
+
+		/**
+		 * The rows sampled for a single value of the stratifying column (or every row for uniform samples)
+		 */
+		struct Stratum {
+			/**
+			 * The amount of rows with this value offered so far
+			 */
+			size_t seen;
+
+			/**
+			 * The rows kept
+			 */
+			std::vector<SampledRow> rows;
+		};
+
+		/**
+		 * The most rows kept
+		 */
+		size_t capacity;
+
+		/**
+		 * The position of the column the sample is stratified by, the maximum size_t for uniform samples
+		 */
+		size_t column;
+
+		/**
+		 * The amount of rows offered so far
+		 */
+		size_t seen;
+
+		/**
+		 * Picks which rows are kept (seeded with a constant, so the same data always gives the same sample)
+		 */
+		std::mt19937_64 random;
+
+		/**
+		 * The strata, one per distinct value of the stratifying column
+		 */
+		std::vector<Stratum> strata;
+
+		/**
+		 * Maps the values of the stratifying column to their stratum
+		 */
+		std::unordered_map<std::string, size_t> strataIndex;
+
+		/**
+		 * Scratch space for the row ends of a block
+		 */
+		std::vector<const char*> rowEnds;
+
+		/**
+		 * Returns the stratum a row belongs to, adding a stratum (and shrinking the others to make room) for new values
+		 *
+		 * @param begin The first byte of the row
+		 * @param end One past the last byte of the row
+		 * @returns The stratum
+		 */
+		Stratum& stratumOf(const char* begin, const char* end);
+
+		/**
+		 * Returns the most rows a stratum keeps, the capacity is split evenly with the remainder going to the first strata
+		 * (so strata after the first `capacity` keep none when there are more strata than rows)
+		 *
+		 * @param stratum The position of the stratum
+		 * @returns The amount of rows
+		 */
+		size_t shareOf(size_t stratum) const;
+
+		/**
+		 * Offers a row to a stratum, keeping it with the probability which keeps the stratum a uniform sample
+		 *
+		 * @param stratum The stratum
+		 * @param begin The first byte of the row
+		 * @param end One past the last byte of the row
+		 */
+		void offer(Stratum& stratum, const char* begin, const char* end);
+
+	public:
+
+		/**
+		 * Creates an empty sample
+		 *
+		 * @throws A string with a description of why the process failed
+		 * @param capacity The most rows to keep
+		 * @param column The position of the column to stratify the sample by, the maximum size_t for a uniform sample
+		 */
+		RowSampler(size_t capacity, size_t column);
+
+		/**
+		 * Offers every row of a block of csv data to the sample
+		 *
+		 * @param begin The first byte of the block (must be the start of a row)
+		 * @param end One past the last byte of the block (must be the end of a row)
+		 */
+		void addRows(const char* begin, const char* end);
+
+		/**
+		 * Returns the amount of rows offered so far
+		 *
+		 * @returns The amount of rows
+		 */
+		size_t rowsSeen() const {
+			return seen;
+		}
+
+		/**
+		 * Hands out the sampled rows as csv data, in the order they were offered
+		 *
+		 * @returns The rows, each ending with a newline
+		 */
+		std::string takeSample();
+	};
+}
\ No newline at end of file
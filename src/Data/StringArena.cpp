@@ -0,0 +1,32 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "StringArena.hpp"
+
+using namespace DataMiner;
+
+/**
+ * Adds all strings of another arena to the end of this one
+ *
+ * @param other The other arena
+ */
+void DataMiner::StringArena::append(const StringArena& other) {
+	uint64_t base = chars.size();
+	chars.insert(chars.end(), other.chars.begin(), other.chars.end());
+	offsets.reserve(offsets.size() + other.size());
+	for (size_t i = 1; i < other.offsets.size(); i++)
+		offsets.push_back(base + other.offsets[i]);
+}
\ No newline at end of file
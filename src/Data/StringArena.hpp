@@ -0,0 +1,108 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * Main data mining namespace
+ */
+namespace DataMiner {
+
+	/**
+	 * Stores a sequence of strings back to back in a single character buffer, with an offsets array marking where
+	 * each string begins and ends
+	 */
+	class StringArena {
+	private:
+
+		/**
+		 * The characters of all strings
+		 */
+		std::vector<char> chars;
+
+		/**
+		 * The start of every string within `chars`, followed by the end of the last string
+		 */
+		std::vector<uint64_t> offsets;
+
+	public:
+
+		/**
+		 * Creates an empty arena
+		 */
+		StringArena() : offsets(1, 0) {}
+
+		/**
+		 * Adds a string to the end of the arena
+		 *
+		 * @param value The string
+		 */
+		void append(std::string_view value) {
+			chars.insert(chars.end(), value.begin(), value.end());
+			offsets.push_back(chars.size());
+		}
+
+		/**
+		 * Adds all strings of another arena to the end of this one
+		 *
+		 * @param other The other arena
+		 */
+		void append(const StringArena& other);
+
+		/**
+		 * Reserves space for strings
+		 *
+		 * @param count The amount of strings
+		 * @param bytes The total length of the strings
+		 */
+		void reserve(size_t count, size_t bytes) {
+			offsets.reserve(count + 1);
+			chars.reserve(bytes);
+		}
+
+		/**
+		 * Returns a string
+		 *
+		 * @param index The index of the string (must be less than `size()`)
+		 * @returns The string
+		 */
+		std::string_view get(size_t index) const {
+			return std::string_view(chars.data() + offsets[index], offsets[index + 1] - offsets[index]);
+		}
+
+		/**
+		 * Returns the amount of strings in the arena
+		 *
+		 * @returns The amount of strings in the arena
+		 */
+		size_t size() const {
+			return offsets.size() - 1;
+		}
+
+		/**
+		 * Returns the total length of the strings in the arena
+		 *
+		 * @returns The total length of the strings in the arena
+		 */
+		size_t bytes() const {
+			return chars.size();
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "StringDictionary.hpp"
+#include <functional>
+
+using namespace DataMiner;
+
+/**
+ * Finds the slot a value lives in, or the empty slot it would be inserted into
+ *
+ * @param value The value to look for
+ * @returns The index of the slot
+ */
+size_t DataMiner::StringDictionary::findSlot(std::string_view value) const {
+	size_t mask = slots.size() - 1;
+	size_t slot = std::hash<std::string_view>()(value) & mask;
+	while (slots[slot] != 0 && values[slots[slot] - 1] != value)
+		slot = (slot + 1) & mask;
+	return slot;
+}
+
+/**
+ * Doubles the size of the hash table
+ */
+void DataMiner::StringDictionary::grow() {
+	slots.assign(slots.size() * 2, 0);
+	for (uint32_t code = 0; code < values.size(); code++)
+		slots[findSlot(values[code])] = code + 1;
+}
+
+/**
+ * Returns the code of a value, adding the value to the dictionary if it is not in it yet
+ *
+ * @param value The value
+ * @returns The code of the value
+ */
+uint32_t DataMiner::StringDictionary::insert(std::string_view value) {
+	size_t slot = findSlot(value);
+	if (slots[slot] != 0)
+		return slots[slot] - 1;
+
+	if (values.size() == npos - 1)
+		throw "Too many distinct values in a column";
+
+	uint32_t code = static_cast<uint32_t>(values.size());
+	values.emplace_back(value);
+
+	// Keep the table at most half full so probe sequences stay short
+	if (values.size() * 2 > slots.size())
+		grow();
+	else
+		slots[slot] = code + 1;
+	return code;
+}
+
+/**
+ * Returns the code of a value
+ *
+ * @param value The value
+ * @returns The code of the value, or `npos` if the value is not in the dictionary
+ */
+uint32_t DataMiner::StringDictionary::find(std::string_view value) const {
+	size_t slot = findSlot(value);
+	return slots[slot] == 0 ? npos : slots[slot] - 1;
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Main data mining namespace
+ */
+namespace DataMiner {
+
+	/**
+	 * Maps the distinct values of a categorical column to small integer codes and back
+	 *
+	 * Codes are handed out in order of first insertion, starting at 0
+	 */
+	class StringDictionary {
+	private:
+
+		/**
+		 * The distinct values, indexed by their code
+		 */
+		std::vector<std::string> values;
+
+		/**
+		 * Open addressing hash table of codes (offset by one so that 0 marks an empty slot)
+		 */
+		std::vector<uint32_t> slots;
+
+		/**
+		 * Finds the slot a value lives in, or the empty slot it would be inserted into
+		 *
+		 * @param value The value to look for
+		 * @returns The index of the slot
+		 */
+		size_t findSlot(std::string_view value) const;
+
+		/**
+		 * Doubles the size of the hash table
+		 */
+		void grow();
+
+	public:
+
+		/**
+		 * Code given to values which are not in the dictionary
+		 */
+		static const uint32_t npos = UINT32_MAX;
+
+		/**
+		 * Creates an empty dictionary
+		 */
+		StringDictionary() : slots(16, 0) {}
+
+		/**
+		 * Returns the code of a value, adding the value to the dictionary if it is not in it yet
+		 *
+		 * @param value The value
+		 * @returns The code of the value
+		 */
+		uint32_t insert(std::string_view value);
+
+		/**
+		 * Returns the code of a value
+		 *
+		 * @param value The value
+		 * @returns The code of the value, or `npos` if the value is not in the dictionary
+		 */
+		uint32_t find(std::string_view value) const;
+
+		/**
+		 * Returns the value of a code
+		 *
+		 * @param code The code (must be less than `size()`)
+		 * @returns The value
+		 */
+		const std::string& get(uint32_t code) const {
+			return values[code];
+		}
+
+		/**
+		 * Returns the amount of distinct values in the dictionary
+		 *
+		 * @returns The amount of distinct values in the dictionary
+		 */
+		size_t size() const {
+			return values.size();
+		}
+	};
+}
\ No newline at end of file
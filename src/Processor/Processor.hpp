@@ -30,6 +30,27 @@ namespace DataMiner {
 	class Processor {
 	public:
 
+		/**
+		 * Frees resources
+		 */
+		virtual ~Processor() = default;
+
+		/**
+		 * Builds the indexes of a dataset which the processor trains from, called before `createProcessor`
+		 * 
+		 * @throws A string with a description of why the task failed
+		 * @param dataset The dataset to train on
+		 */
+		virtual void prepareDataset(Data& /*dataset*/) {}
+
+		/**
+		 * Sets the amount of threads the processor is created on, called before `createProcessor` (processors which only
+		 * run on a single thread ignore it)
+		 * 
+		 * @param threads The amount of threads (0 for one per core)
+		 */
+		virtual void setThreads(size_t /*threads*/) {}
+
 		/**
 		 * Creates a processor given a dataset to train on
 		 * 
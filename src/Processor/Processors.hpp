@@ -64,6 +64,12 @@ namespace DataMiner {
 			[](void){
 				return (Processor*) new Algorithm::DecisionTreeVarianceReduction();
 			}
+		},
+		{
+			"Desicion Tree - Variance Reduction Splitting Method (Numerically Stable)",
+			[](void){
+				return (Processor*) new Algorithm::DecisionTreeVarianceReduction(true);
+			}
 		}
 	};
 }
\ No newline at end of file
@@ -17,11 +17,42 @@
 #include "Task.hpp"
 #include <Logger/Logger.hpp>
 #include <Data/Data.hpp>
+#include <Data/DataStream.hpp>
 #include <Processor/Processors.hpp>
+#include <memory>
 #include <sstream>
 
 using namespace DataMiner;
 
+/**
+ * The most threads a processor can be created on
+ */
+static const size_t maxThreads = 256;
+
+/**
+ * Helper function to print the predictions of a processor for every row of a dataset
+ * 
+ * @throws A string with a description of why the task failed
+ * @param processor The processor to predict with
+ * @param dataset The dataset to predict the rows of
+ * @param firstRow The number of the dataset's first row within the whole dataset
+ */
+static void printPredictions(Processor* processor, const Data& dataset, size_t firstRow) {
+	DataType targetType = dataset.getTarget().type;
+
+	for (size_t row = 0; row < dataset.numRows(); row++) {
+		std::stringstream str;
+		str << "Row " << (firstRow + row + 1) << " -> ";
+
+		if (targetType == DataType::number)
+			str << processor->predictNumerical(dataset.getRow(row));
+		if (targetType == DataType::string)
+			str << processor->predictCategorical(dataset.getRow(row));
+
+		logger->print(str.str().c_str());
+	}
+}
+
 /**
  * Creates a new task
  */
@@ -79,11 +110,17 @@ void DataMiner::Task::run() {
 	
 
 	try {
-		Processor* processor = ProcessorList[algorithms[algorithm - 1]]();
+		std::unique_ptr<Processor> processor(ProcessorList[algorithms[algorithm - 1]]());
 
 		if (taskAction == TaskAction::createModel) {
+			size_t threads = logger->getInput<size_t>("How many threads would you like to create the processor on? (Input a number, 0 for one per core)", [](const size_t& value) {
+				return value <= maxThreads;
+			});
+			processor->setThreads(threads);
+
 			logger->print("Now beginning model creation task, to proceed you must open a dataset to train from");
-			const Data dataset;
+			Data dataset;
+			processor->prepareDataset(dataset);
 			processor->createProcessor(dataset);
 
 			bool save = logger->getInput<std::string>("Would you like to save the data processor? (Y/N)", [](const std::string& value) {
@@ -97,30 +134,39 @@ void DataMiner::Task::run() {
 		}
 		if (taskAction == TaskAction::loadModel) {
 			logger->print("To use a model for predictions you must import a dataset containing all colummns and data for predictions (You can leave the target column blank on all rows)");
-			const Data dataset;
+			bool stream = logger->getInput<std::string>("Would you like to read the dataset in batches? This keeps memory use bounded for datasets larger than memory. (Y/N)", [](const std::string& value) {
+				return value == "Y" || value == "N";
+			}) == "Y";
+
+			if (stream) {
+				DataStream dataset;
 
-			logger->print("Now beginning model loading task, to proceed you must open a file to which the processor previously saved to");
-			std::string fileName = logger->getInput<std::string>("Please input the name of the file to which the processor was previously saved to");
-			processor->loadProcessor(dataset, fileName.c_str());
+				logger->print("Now beginning model loading task, to proceed you must open a file to which the processor previously saved to");
+				std::string fileName = logger->getInput<std::string>("Please input the name of the file to which the processor was previously saved to");
+				processor->loadProcessor(dataset.getBatch(), fileName.c_str());
 
-			DataType targetType = dataset.getTarget().type;
+				logger->info("Now showing all predictions:");
+				size_t batches = 0;
+				while (dataset.nextBatch()) {
+					printPredictions(processor.get(), dataset.getBatch(), dataset.batchFirstRow());
+					batches++;
+				}
 
-			// TODO - Prediction process
-			logger->info("Now showing all predictions:");
-			for (size_t row = 0; row < dataset.numRows(); row++) {
 				std::stringstream str;
-				str << "Row " << (row + 1) << " -> ";
+				str << "Predicted " << (dataset.batchFirstRow() + dataset.getBatch().numRows()) << " rows in " << batches << " batch(es)";
+				logger->info(str.str().c_str());
+			}
+			else {
+				const Data dataset;
 
-				if (targetType == DataType::number)
-					str << processor->predictNumerical(dataset.getRow(row));
-				if (targetType == DataType::string)
-					str << processor->predictCategorical(dataset.getRow(row));
+				logger->print("Now beginning model loading task, to proceed you must open a file to which the processor previously saved to");
+				std::string fileName = logger->getInput<std::string>("Please input the name of the file to which the processor was previously saved to");
+				processor->loadProcessor(dataset, fileName.c_str());
 
-				logger->print(str.str().c_str());
+				logger->info("Now showing all predictions:");
+				printPredictions(processor.get(), dataset, 0);
 			}
 		}
-
-		delete processor;
 	}
 	catch (const char* error) {
 		std::stringstream errStream;
@@ -0,0 +1,120 @@
+/*
+   Copyright 2021 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <Data/Data.hpp>
+#include <Logger/Logger.hpp>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace DataMiner;
+
+/**
+ * Amount of checks which failed
+ */
+static int failures = 0;
+
+/**
+ * Helper function to record a failed check
+ * 
+ * @param passed Whether or not the check passed
+ * @param message What was checked
+ */
+static void check(bool passed, const char* message) {
+	if (!passed) {
+		std::cerr << "FAILED: " << message << std::endl;
+		failures++;
+	}
+}
+
+/**
+ * Helper function to write a csv file
+ * 
+ * @param filename The name of the file
+ * @param contents The contents of the file
+ */
+static void writeFile(const char* filename, const char* contents) {
+	std::ofstream file(filename, std::ios::binary);
+	file << contents;
+}
+
+/**
+ * Helper function to compare two numbers, treating missing values as equal
+ * 
+ * @param first The first number
+ * @param second The second number
+ * @returns Whether or not the numbers are the same
+ */
+static bool sameNumber(double first, double second) {
+	return (std::isnan(first) && std::isnan(second)) || first == second;
+}
+
+/**
+ * Appends rows which need wider types to a narrowed dataset, and checks it matches loading every row at once
+ */
+int main() {
+	Logger log("DataAppendTest.log");
+	logger = &log;
+
+	// Every dataset is loaded with a header row, the default roles, no sample and no cache
+	std::istringstream answers("Y\nN\nN\nN\nY\nN\nN\nN\n");
+	std::streambuf* input = std::cin.rdbuf(answers.rdbuf());
+
+	// small stays int8 (with a missing value), wide grows from int8 to int16, fraction grows from float32 to float64 and
+	// edge grows to int16 because -128 marks missing values of int8 columns
+	writeFile("append_first.csv", "small,wide,fraction,edge\n1,2,0.5,3\n-4,5,1.25,-6\n,7,2.75,8\n9,-10,3.5,11\n");
+	writeFile("append_second.csv", "small,wide,fraction,edge\n12,300,0.1,-128\n-13,-20000,4.5,14\n15,16,,17\n");
+	writeFile("append_all.csv", "small,wide,fraction,edge\n1,2,0.5,3\n-4,5,1.25,-6\n,7,2.75,8\n9,-10,3.5,11\n"
+		"12,300,0.1,-128\n-13,-20000,4.5,14\n15,16,,17\n");
+
+	try {
+		Data appended("append_first.csv");
+		const Data loaded("append_all.csv");
+		const Data& before = appended;
+		check(before.getColumn("small").storage == NumberStorage::int8, "small is narrowed to int8 before the append");
+		check(before.getColumn("wide").storage == NumberStorage::int8, "wide is narrowed to int8 before the append");
+		check(before.getColumn("fraction").storage == NumberStorage::float32, "fraction is narrowed to float32 before the append");
+		check(before.getColumn("edge").storage == NumberStorage::int8, "edge is narrowed to int8 before the append");
+
+		check(appended.appendCsv("append_second.csv") == 3, "every row of the second file is appended");
+
+		const Data& after = appended;
+		check(after.numRows() == loaded.numRows(), "the appended dataset has every row");
+		check(after.getColumn("small").storage == NumberStorage::int8, "small keeps int8 after the append");
+		check(after.getColumn("wide").storage == NumberStorage::int16, "wide is widened to int16");
+		check(after.getColumn("fraction").storage == NumberStorage::float64, "fraction is widened to float64");
+		check(after.getColumn("edge").storage == NumberStorage::int16, "edge is widened to int16");
+		for (size_t column = 0; column < loaded.numColumns(); column++) {
+			const DataColumn& expected = loaded.getColumn(column);
+			const DataColumn& actual = after.getColumn(column);
+			check(actual.storage == expected.storage, "the storage types match a full load");
+			check(actual.nullCount == expected.nullCount, "the missing value counts match a full load");
+			check(sameNumber(actual.min, expected.min) && sameNumber(actual.max, expected.max), "the ranges match a full load");
+			for (size_t row = 0; row < loaded.numRows() && row < after.numRows(); row++)
+				check(sameNumber(after.getNumber(column, row), loaded.getNumber(column, row)), "the values match a full load");
+		}
+	}
+	catch (const char* error) {
+		std::cerr << "FAILED: " << error << std::endl;
+		failures++;
+	}
+
+	std::cin.rdbuf(input);
+	if (failures == 0)
+		std::cout << "All checks passed" << std::endl;
+	return failures == 0 ? 0 : 1;
+}
\ No newline at end of file